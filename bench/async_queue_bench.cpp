@@ -0,0 +1,130 @@
+/*************************************************
+  * 描述：异步队列扩展性基准
+  *
+  * 异步 logger + null sink，1~64 个线程同时打 LOG_INFO，对比两种 async_queue：
+  *  - shared：spdlog 线程池的共享队列（所有生产者共用一把锁）
+  *  - per_thread：每个线程一条无锁单生产者队列，worker 按时间戳归并
+  * 每种队列列出两项：
+  *  - 入队吞吐：所有线程打完日志的耗时折算的总条数/秒（调用方看到的开销）
+  *  - 端到端吞吐：包含 shutdown 排空队列的耗时
+  * 队列满时阻塞等待（block），shared 队列容量 65536，per_thread 每个线程 65536/线程数（不少于 1024），总容量大致相当
+  *
+  * 另外以单线程突发写普通文件（basic_file_sink_mt）对比 per_thread worker 的批量写入：async_batch_size 为 1（逐条写）
+  * 与 256，flush_on 分别为 off 与 trace（每条都要求刷新，批量时每批只刷新一次），给出含排空的端到端吞吐
+  *
+  * 线程数超过 CPU 核数时结果主要反映调度开销，锁争用只有在多核上才能体现
+  *
+  * File：async_queue_bench.cpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#include "bench_common.h"
+
+#include <logger/logger.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace
+{
+    struct Throughput
+    {
+        double enqueue = 0;  // 条/秒
+        double endToEnd = 0; // 条/秒
+    };
+
+    Throughput measure(const std::string& queue, int threads, std::uint64_t perThread)
+    {
+        const int queueSize = queue == "per_thread" ? std::max(65536 / threads, 1024) : 65536;
+        Logger::setConfigPath(Bench::writeNullSinkConfig("async_queue_" + queue, true, queue, queueSize), false);
+        // 预热 worker；各生产者线程的队列在其第一次打日志时创建，计入计时
+        LOG_INFO("warm up");
+
+        const auto start = Bench::Clock::now();
+        const auto enqueued = Bench::runThreads(threads, [&](int tid) {
+            for (std::uint64_t i = 0; i < perThread; ++i)
+            {
+                LOG_INFO("async queue ", tid, " msg ", i, " value ", 0.5);
+            }
+        });
+        Logger::shutdown();
+        const auto drained = Bench::Clock::now() - start;
+
+        const double total = static_cast<double>(perThread * threads);
+        Throughput result;
+        result.enqueue = total / std::chrono::duration<double>(enqueued).count();
+        result.endToEnd = total / std::chrono::duration<double>(drained).count();
+        return result;
+    }
+
+    std::string writeFileConfig(int batchSize, const std::string& flushOn)
+    {
+        const std::string path = "./bench_async_batch.yaml";
+        std::ofstream f(path);
+        f << "log_config:\n"
+          << "  logger:\n"
+          << "    name: bench-batch\n"
+          << "    debug_level: trace\n"
+          << "    release_level: trace\n"
+          << "    flush_on: " << flushOn << "\n"
+          << "    pattern: \"[%Y-%m-%d %H:%M:%S.%e][%n][%l][thread %t]%v\"\n"
+          << "    async: true\n"
+          << "    async_queue: per_thread\n"
+          << "    async_queue_size: 65536\n"
+          << "    async_batch_size: " << batchSize << "\n"
+          << "  showCodeLine:\n"
+          << "    trace: false\n    debug: false\n    info: false\n"
+          << "    warn: false\n    error: false\n    critical: false\n"
+          << "  sinks:\n"
+          << "    - type: basic_file_sink_mt\n"
+          << "      level: trace\n"
+          << "      file_path: ./bench_async_batch.log\n"
+          << "      truncate: true\n";
+        return path;
+    }
+
+    double fileBurst(int batchSize, const std::string& flushOn, std::uint64_t count)
+    {
+        Logger::setConfigPath(writeFileConfig(batchSize, flushOn), false);
+        LOG_INFO("warm up");
+        const auto start = Bench::Clock::now();
+        for (std::uint64_t i = 0; i < count; ++i)
+        {
+            LOG_INFO("file burst msg ", i, " value ", 0.5);
+        }
+        Logger::shutdown();
+        const double seconds = std::chrono::duration<double>(Bench::Clock::now() - start).count();
+        std::filesystem::remove("./bench_async_batch.log");
+        return static_cast<double>(count) / seconds;
+    }
+}// namespace
+
+int Bench::runAsyncQueueBench(const Options& options)
+{
+    std::printf("CPU 核数: %u\n", std::thread::hardware_concurrency());
+    std::printf("%-8s %18s %18s %18s %18s\n", "threads", "shared 入队/s", "shared 端到端/s", "per_thread 入队/s",
+                "per_thread 端到端/s");
+    for (const int threads: options.threads)
+    {
+        const std::uint64_t perThread = options.iterations / 4 / threads + 1;
+        const Throughput shared = measure("shared", threads, perThread);
+        const Throughput perThreadQueue = measure("per_thread", threads, perThread);
+        std::printf("%-8d %18.0f %18.0f %18.0f %18.0f\n", threads, shared.enqueue, shared.endToEnd,
+                    perThreadQueue.enqueue, perThreadQueue.endToEnd);
+    }
+
+    const std::uint64_t burst = options.iterations / 4 + 1;
+    std::printf("\n文件突发写入（per_thread，端到端 条/秒）\n");
+    std::printf("%-10s %16s %16s\n", "flush_on", "batch=1", "batch=256");
+    for (const std::string flushOn: {"off", "trace"})
+    {
+        const double single = fileBurst(1, flushOn, burst);
+        const double batched = fileBurst(256, flushOn, burst);
+        std::printf("%-10s %16.0f %16.0f\n", flushOn.c_str(), single, batched);
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+/*************************************************
+  * 描述：基准测试公共工具
+  *
+  * File：bench_common.h
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#ifndef LOGGER_BENCH_COMMON_H
+#define LOGGER_BENCH_COMMON_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Bench
+{
+    using Clock = std::chrono::steady_clock;
+
+    /// 阻止编译器把基准循环中的结果优化掉
+    template<typename T>
+    inline void doNotOptimize(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    inline double nsPerOp(Clock::duration elapsed, std::uint64_t ops)
+    {
+        return ops ? static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / ops : 0.0;
+    }
+
+    /**
+     * threads 个线程同时起跑执行 fn(线程序号)，返回从起跑到全部结束的耗时
+     */
+    template<typename Fn>
+    Clock::duration runThreads(int threads, Fn&& fn)
+    {
+        std::atomic<int> ready{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&, t] {
+                ready.fetch_add(1);
+                while (!go.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+                fn(t);
+            });
+        }
+        while (ready.load() < threads)
+            std::this_thread::yield();
+        const auto start = Clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto& worker: workers)
+            worker.join();
+        return Clock::now() - start;
+    }
+
+    /**
+     * 写一份只输出到 null sink 的配置，返回配置文件路径
+     * @param queue 异步队列类型（async_queue：shared / per_thread）
+     * @param queueSize 异步队列容量（per_thread 时为每个线程的容量）
+     */
+    std::string writeNullSinkConfig(const std::string& name, bool async, const std::string& queue = "shared",
+                                    int queueSize = 65536);
+
+    /// 命令行参数（基准套件共用）
+    struct Options
+    {
+        std::uint64_t iterations = 1000000;
+        std::vector<int> threads{1, 2, 4, 8, 16, 32, 64};
+        std::vector<std::string> suites;// 为空时运行全部
+        std::string json;                // 非空时 overhead 套件把结果另写为该路径的 JSON
+        // latency 套件
+        std::vector<std::string> configs; // 日志配置文件，为空时使用 bench/configs 下的全部配置
+        std::vector<std::string> profiles;// 负载：steady / bursty / threads，为空时运行全部
+        std::uint64_t rate = 100000;      // steady 负载的速率（条/秒）
+        std::uint64_t burst = 1000;       // bursty 负载每次突发的条数
+        bool tsc = false;                 // 用 TSC 计时（仅 x86），默认 steady_clock
+        std::string csv;                  // 非空时把结果另写为该路径的 CSV
+    };
+
+    /// 各基准套件入口，返回 0 表示成功
+    int runDispatchBench(const Options& options);
+    int runNumbersBench(const Options& options);
+    int runUtf8Bench(const Options& options);
+    int runScalingBench(const Options& options);
+    int runCallbackBench(const Options& options);
+    int runAsyncQueueBench(const Options& options);
+    int runOverheadBench(const Options& options);
+    int runLatencyBench(const Options& options);
+}// namespace Bench
+
+#endif// LOGGER_BENCH_COMMON_H
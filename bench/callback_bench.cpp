@@ -0,0 +1,66 @@
+/*************************************************
+  * 描述：回调开销基准
+  *
+  * 同步 logger + null sink，挂一个同步回调后测 LOG_INFO 每条的耗时：
+  *  - LogMsg：旧接口，每条日志格式化并拷贝为六个 std::string
+  *  - view(level)：视图回调只读取 level，不触发 pattern 格式化
+  *  - view(formatted)：视图回调读取 msgFormatted()，按需格式化
+  *
+  * File：callback_bench.cpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#include "bench_common.h"
+
+#include <logger/logger.h>
+
+#include <cstdio>
+#include <functional>
+
+namespace
+{
+    double measure(std::uint64_t iterations, const std::function<std::string()>& attach)
+    {
+        const std::string sinkId = attach();
+        for (std::uint64_t i = 0; i < iterations / 10; ++i)
+        {
+            LOG_INFO("callback bench ", i);
+        }
+        const auto start = Bench::Clock::now();
+        for (std::uint64_t i = 0; i < iterations; ++i)
+        {
+            LOG_INFO("callback bench ", i);
+        }
+        const auto elapsed = Bench::Clock::now() - start;
+        Logger::removeCallBack(sinkId);
+        return Bench::nsPerOp(elapsed, iterations);
+    }
+}// namespace
+
+int Bench::runCallbackBench(const Options& options)
+{
+    Logger::setConfigPath(writeNullSinkConfig("callback", false), false);
+    long sink = 0;
+
+    const double none = measure(options.iterations, [] { return std::string(); });
+    const double logMsg = measure(options.iterations, [&] {
+        return Logger::addCallBack([&](const LogMsg& msg) { sink += static_cast<int>(msg.level); }, LogLevel::Trace);
+    });
+    const double viewLevel = measure(options.iterations, [&] {
+        return Logger::addCallBack([&](const LogMsgView& view) { sink += static_cast<int>(view.level); }, LogLevel::Trace);
+    });
+    const double viewFormatted = measure(options.iterations, [&] {
+        return Logger::addCallBack([&](const LogMsgView& view) { sink += static_cast<long>(view.msgFormatted().size()); },
+                                   LogLevel::Trace);
+    });
+    doNotOptimize(sink);
+
+    std::printf("%-20s %10s\n", "callback", "ns/op");
+    std::printf("%-20s %10.1f\n", "none", none);
+    std::printf("%-20s %10.1f\n", "LogMsg", logMsg);
+    std::printf("%-20s %10.1f\n", "view(level)", viewLevel);
+    std::printf("%-20s %10.1f\n", "view(formatted)", viewFormatted);
+    Logger::shutdown();
+    return 0;
+}
@@ -0,0 +1,131 @@
+/*************************************************
+  * 描述：std::any 参数分发基准
+  *
+  * 对比单个参数文本化的开销（ns/参数）：
+  *  - map+function：最初的实现，unordered_map<type_index, std::function> 返回 optional<string>
+  *  - map：unordered_map<type_index, 函数指针>，就地追加
+  *  - flat：当前的 LoggerUtil::appendAny（快速路径 + 以 type_info 地址为键的平坦散列表）
+  *  - static：不经过 std::any，按静态类型直接追加（LOG_* 宏实际走的路径）
+  *
+  * File：dispatch_bench.cpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#include "bench_common.h"
+
+#include <logger/anytostring.hpp>
+
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <typeindex>
+#include <unordered_map>
+
+namespace
+{
+    using LegacyConverter = std::function<std::optional<std::string>(const std::any&)>;
+
+    const std::unordered_map<std::type_index, LegacyConverter>& legacyConverters()
+    {
+        static const std::unordered_map<std::type_index, LegacyConverter> map = {
+                {std::type_index(typeid(std::string)),
+                 [](const std::any& a) -> std::optional<std::string> { return std::any_cast<std::string>(a); }},
+                {std::type_index(typeid(const char*)),
+                 [](const std::any& a) -> std::optional<std::string> { return std::any_cast<const char*>(a); }},
+                {std::type_index(typeid(int)),
+                 [](const std::any& a) -> std::optional<std::string> { return std::to_string(std::any_cast<int>(a)); }},
+                {std::type_index(typeid(long long)),
+                 [](const std::any& a) -> std::optional<std::string> { return std::to_string(std::any_cast<long long>(a)); }},
+                {std::type_index(typeid(unsigned long)),
+                 [](const std::any& a) -> std::optional<std::string> { return std::to_string(std::any_cast<unsigned long>(a)); }},
+                {std::type_index(typeid(double)),
+                 [](const std::any& a) -> std::optional<std::string> { return LoggerUtil::floatingNumToString(std::any_cast<double>(a)); }},
+                {std::type_index(typeid(bool)),
+                 [](const std::any& a) -> std::optional<std::string> { return std::any_cast<bool>(a) ? std::string("true") : std::string("false"); }},
+        };
+        return map;
+    }
+
+    bool legacyAppend(std::string& out, const std::any& data)
+    {
+        auto& converters = legacyConverters();
+        auto it = converters.find(std::type_index(data.type()));
+        if (it == converters.end())
+            return false;
+        auto text = it->second(data);
+        if (!text)
+            return false;
+        out.append(*text);
+        return true;
+    }
+
+    const std::unordered_map<std::type_index, LoggerUtil::AnyAppender>& mapAppenders()
+    {
+        static const std::unordered_map<std::type_index, LoggerUtil::AnyAppender> map = {
+                {std::type_index(typeid(std::string)), &LoggerUtil::appendAnyAs<std::string>},
+                {std::type_index(typeid(const char*)), &LoggerUtil::appendAnyAs<const char*>},
+                {std::type_index(typeid(int)), &LoggerUtil::appendAnyAs<int>},
+                {std::type_index(typeid(long long)), &LoggerUtil::appendAnyAs<long long>},
+                {std::type_index(typeid(unsigned long)), &LoggerUtil::appendAnyAs<unsigned long>},
+                {std::type_index(typeid(double)), &LoggerUtil::appendAnyAs<double>},
+                {std::type_index(typeid(bool)), &LoggerUtil::appendAnyAs<bool>},
+        };
+        return map;
+    }
+
+    bool mapAppend(std::string& out, const std::any& data)
+    {
+        auto& appenders = mapAppenders();
+        auto it = appenders.find(std::type_index(data.type()));
+        if (it == appenders.end())
+            return false;
+        it->second(out, data, LoggerUtil::kShortestFloat);
+        return true;
+    }
+
+    template<typename Fn>
+    double measure(std::uint64_t iterations, Fn&& fn)
+    {
+        std::string out;
+        out.reserve(256);
+        for (std::uint64_t i = 0; i < iterations / 10; ++i)// 预热
+        {
+            out.clear();
+            fn(out);
+        }
+        const auto start = Bench::Clock::now();
+        for (std::uint64_t i = 0; i < iterations; ++i)
+        {
+            out.clear();
+            fn(out);
+            Bench::doNotOptimize(out);
+        }
+        return Bench::nsPerOp(Bench::Clock::now() - start, iterations);
+    }
+
+    template<typename T>
+    void benchType(const char* name, const T& value, std::uint64_t iterations)
+    {
+        const std::any boxed(value);
+        const double legacy = measure(iterations, [&](std::string& out) { legacyAppend(out, boxed); });
+        const double map = measure(iterations, [&](std::string& out) { mapAppend(out, boxed); });
+        const double flat = measure(iterations, [&](std::string& out) { LoggerUtil::appendAny(out, boxed); });
+        const double direct = measure(iterations, [&](std::string& out) { LoggerUtil::appendArg(out, value); });
+        std::printf("%-14s %14.1f %10.1f %10.1f %10.1f\n", name, legacy, map, flat, direct);
+    }
+}// namespace
+
+int Bench::runDispatchBench(const Options& options)
+{
+    const std::uint64_t n = options.iterations;
+    std::printf("%-14s %14s %10s %10s %10s   (ns/参数)\n", "type", "map+function", "map", "flat", "static");
+    benchType("std::string", std::string("sensor-01"), n);
+    benchType("const char*", static_cast<const char*>("hello"), n);
+    benchType("int", 123456, n);
+    benchType("long long", -9876543210LL, n);
+    benchType("unsigned long", 42UL, n);
+    benchType("double", 3.14159, n);
+    benchType("bool", true, n);
+    return 0;
+}
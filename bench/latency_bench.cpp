@@ -0,0 +1,278 @@
+/*************************************************
+  * 描述：日志调用尾延迟基准
+  *
+  * 逐条计时 LOG_INFO 调用（调用方看到的耗时），记入延迟直方图（latency_histogram.h），输出 p50 / p99 / p99.9 / max：
+  *  - 计时：默认 steady_clock；--clock tsc 时在 x86 上读 TSC（启动时对照 steady_clock 标定频率，需 invariant TSC）
+  *  - sink 配置：--configs 指定的 YAML 文件，未指定时使用 bench/configs 下的全部配置
+  *    （按行数滚动 + flush_on: trace、日期+大小滚动、小队列阻塞的异步、按线程分队列的异步）
+  *  - 负载（--profiles 选择，默认全部）：
+  *      steady：单线程按 --rate 条/秒匀速打日志（等待下一个时间点的时间不计入）
+  *      bursty：单线程每次连续打 --burst 条，之后空闲 10ms
+  *      threads：--threads 中最大的线程数同时不间断打日志
+  * 每种负载重新加载一次配置，每个线程先打 100 条不计时的预热日志；负载结束后 shutdown 排空（不计时）
+  * 每种 配置 × 负载 记录 iterations / 4 条，--csv 时另把结果写成 CSV（每种组合一行，单位 ns）
+  *
+  * 配置中的日志文件按原路径写出，不会被删除（bench/configs 下的配置均写到 ./bench_logs）
+  *
+  * File：latency_bench.cpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#include "bench_common.h"
+#include "latency_histogram.h"
+
+#include <logger/logger.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define LOGGER_BENCH_HAS_TSC 1
+#else
+#define LOGGER_BENCH_HAS_TSC 0
+#endif
+
+#ifndef LOGGER_BENCH_CONFIG_DIR
+#define LOGGER_BENCH_CONFIG_DIR "./configs"
+#endif
+
+namespace
+{
+    constexpr std::uint64_t kWarmUp = 100;
+    constexpr auto kBurstGap = std::chrono::milliseconds(10);
+
+    /// 计时源：steady_clock 或 TSC，读数统一换算为纳秒
+    class CallTimer
+    {
+    public:
+        explicit CallTimer(bool tsc) : tsc_(tsc && LOGGER_BENCH_HAS_TSC)
+        {
+            if (tsc_)
+                calibrate();
+        }
+
+        bool tsc() const { return tsc_; }
+
+        std::uint64_t now() const
+        {
+#if LOGGER_BENCH_HAS_TSC
+            if (tsc_)
+                return __rdtsc();
+#endif
+            return static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(Bench::Clock::now().time_since_epoch()).count());
+        }
+
+        std::uint64_t toNs(std::uint64_t ticks) const
+        {
+            return tsc_ ? static_cast<std::uint64_t>(static_cast<double>(ticks) * nsPerTick_) : ticks;
+        }
+
+    private:
+        void calibrate()
+        {
+            const auto start = Bench::Clock::now();
+            const std::uint64_t startTicks = now();
+            while (Bench::Clock::now() - start < std::chrono::milliseconds(50))
+            {
+            }
+            const std::uint64_t ticks = now() - startTicks;
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Bench::Clock::now() - start);
+            nsPerTick_ = ticks ? static_cast<double>(elapsed.count()) / static_cast<double>(ticks) : 1.0;
+        }
+
+        bool tsc_;
+        double nsPerTick_ = 1.0;
+    };
+
+    struct Row
+    {
+        std::string config;
+        std::string profile;
+        int threads = 0;
+        Bench::LatencyHistogram histogram;
+    };
+
+    /// 打一条日志并记入直方图
+    inline void timedCall(const CallTimer& timer, Bench::LatencyHistogram& histogram, std::uint64_t i)
+    {
+        const std::uint64_t start = timer.now();
+        LOG_INFO("latency ", i, " user ", "alice", " value ", 0.5);
+        histogram.record(timer.toNs(timer.now() - start));
+    }
+
+    void warmUp()
+    {
+        for (std::uint64_t i = 0; i < kWarmUp; ++i)
+        {
+            LOG_INFO("warm up ", i);
+        }
+    }
+
+    Bench::LatencyHistogram runSteady(const CallTimer& timer, std::uint64_t samples, std::uint64_t rate)
+    {
+        Bench::LatencyHistogram histogram;
+        warmUp();
+        const auto interval = std::chrono::nanoseconds(1000000000ull / std::max<std::uint64_t>(rate, 1));
+        auto next = Bench::Clock::now();
+        for (std::uint64_t i = 0; i < samples; ++i)
+        {
+            while (Bench::Clock::now() < next)
+            {
+            }
+            next += interval;
+            timedCall(timer, histogram, i);
+        }
+        return histogram;
+    }
+
+    Bench::LatencyHistogram runBursty(const CallTimer& timer, std::uint64_t samples, std::uint64_t burst)
+    {
+        Bench::LatencyHistogram histogram;
+        warmUp();
+        burst = std::max<std::uint64_t>(burst, 1);
+        for (std::uint64_t i = 0; i < samples; ++i)
+        {
+            if (i > 0 && i % burst == 0)
+                std::this_thread::sleep_for(kBurstGap);
+            timedCall(timer, histogram, i);
+        }
+        return histogram;
+    }
+
+    Bench::LatencyHistogram runManyThreads(const CallTimer& timer, std::uint64_t samples, int threads)
+    {
+        std::vector<Bench::LatencyHistogram> perThread(threads);
+        const std::uint64_t count = samples / threads + 1;
+        Bench::runThreads(threads, [&](int tid) {
+            warmUp();
+            for (std::uint64_t i = 0; i < count; ++i)
+                timedCall(timer, perThread[tid], i);
+        });
+        Bench::LatencyHistogram histogram;
+        for (const auto& h: perThread)
+            histogram.merge(h);
+        return histogram;
+    }
+
+    std::vector<std::string> defaultConfigs()
+    {
+        std::vector<std::string> configs;
+        std::error_code ec;
+        for (const auto& entry: std::filesystem::directory_iterator(LOGGER_BENCH_CONFIG_DIR, ec))
+        {
+            if (entry.path().extension() == ".yaml")
+                configs.push_back(entry.path().string());
+        }
+        std::sort(configs.begin(), configs.end());
+        return configs;
+    }
+
+    bool writeCsv(const std::string& path, const CallTimer& timer, const std::vector<Row>& rows)
+    {
+        std::ofstream f(path, std::ios::out | std::ios::trunc);
+        f << "config,profile,clock,threads,samples,p50_ns,p99_ns,p999_ns,max_ns,mean_ns\n";
+        for (const Row& row: rows)
+        {
+            const auto& h = row.histogram;
+            f << row.config << ',' << row.profile << ',' << (timer.tsc() ? "tsc" : "steady") << ',' << row.threads << ','
+              << h.count() << ',' << h.percentile(50) << ',' << h.percentile(99) << ',' << h.percentile(99.9) << ','
+              << h.max() << ',' << static_cast<std::uint64_t>(h.mean()) << '\n';
+        }
+        return static_cast<bool>(f);
+    }
+}// namespace
+
+int Bench::runLatencyBench(const Options& options)
+{
+    const CallTimer timer(options.tsc);
+    if (options.tsc && !timer.tsc())
+        std::printf("当前平台不支持 TSC，改用 steady_clock\n");
+
+    const std::vector<std::string> configs = options.configs.empty() ? defaultConfigs() : options.configs;
+    if (configs.empty())
+    {
+        std::fprintf(stderr, "没有可用的配置文件（%s 下无 .yaml，可用 --configs 指定）\n", LOGGER_BENCH_CONFIG_DIR);
+        return 1;
+    }
+    const std::vector<std::string> profiles =
+            options.profiles.empty() ? std::vector<std::string>{"steady", "bursty", "threads"} : options.profiles;
+    const int maxThreads = options.threads.empty() ? 1 : *std::max_element(options.threads.begin(), options.threads.end());
+    const std::uint64_t samples = options.iterations / 4 + 1;
+
+    std::printf("CPU 核数: %u，计时: %s，每项 %llu 条\n", std::thread::hardware_concurrency(), timer.tsc() ? "tsc" : "steady_clock",
+                static_cast<unsigned long long>(samples));
+    std::printf("%-28s %-8s %-8s %10s %10s %10s %12s\n", "config", "profile", "threads", "p50(ns)", "p99(ns)", "p99.9(ns)",
+                "max(ns)");
+
+    for (const std::string& config: configs)
+    {
+        // 不存在时 setConfigPath 会按默认配置生成该文件，测到的就不是想要的配置
+        if (!std::filesystem::exists(config))
+        {
+            std::fprintf(stderr, "配置文件不存在: %s\n", config.c_str());
+            return 1;
+        }
+    }
+
+    std::vector<Row> rows;
+    for (const std::string& config: configs)
+    {
+        for (const std::string& profile: profiles)
+        {
+            Row row;
+            row.config = std::filesystem::path(config).stem().string();
+            row.profile = profile;
+            row.threads = 1;
+
+            Logger::setConfigPath(config, false);
+            if (profile == "steady")
+            {
+                row.histogram = runSteady(timer, samples, options.rate);
+            }
+            else if (profile == "bursty")
+            {
+                row.histogram = runBursty(timer, samples, options.burst);
+            }
+            else if (profile == "threads")
+            {
+                row.threads = maxThreads;
+                row.histogram = runManyThreads(timer, samples, maxThreads);
+            }
+            else
+            {
+                std::fprintf(stderr, "未知的负载: %s（可用 steady / bursty / threads）\n", profile.c_str());
+                Logger::shutdown();
+                return 1;
+            }
+            Logger::shutdown();
+
+            const auto& h = row.histogram;
+            std::printf("%-28s %-8s %-8d %10llu %10llu %10llu %12llu\n", row.config.c_str(), profile.c_str(), row.threads,
+                        static_cast<unsigned long long>(h.percentile(50)), static_cast<unsigned long long>(h.percentile(99)),
+                        static_cast<unsigned long long>(h.percentile(99.9)), static_cast<unsigned long long>(h.max()));
+            rows.push_back(std::move(row));
+        }
+    }
+
+    if (!options.csv.empty())
+    {
+        if (!writeCsv(options.csv, timer, rows))
+        {
+            std::fprintf(stderr, "写入 CSV 结果失败: %s\n", options.csv.c_str());
+            return 1;
+        }
+        std::printf("CSV 结果: %s\n", options.csv.c_str());
+    }
+    return 0;
+}
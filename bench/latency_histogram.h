@@ -0,0 +1,109 @@
+/*************************************************
+  * 描述：延迟直方图（HDR 风格的对数-线性分桶）
+  *
+  *  - 小于 128 的值每个值一个桶（精确）；之后每个 2 的幂区间再均分为 128 个子桶，相对误差不超过 1/128
+  *  - 覆盖整个 uint64 范围，桶数固定（约 7300 个），记录只做一次最高位计算与一次自增，不分配内存
+  *  - 不加锁：每个线程记录自己的直方图，结束后 merge 汇总
+  *  - percentile 返回所在桶的上界（不超过记录到的最大值），与 HdrHistogram 的 highestEquivalentValue 一致
+  *
+  * File：latency_histogram.h
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#ifndef LOGGER_BENCH_LATENCY_HISTOGRAM_H
+#define LOGGER_BENCH_LATENCY_HISTOGRAM_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace Bench
+{
+    class LatencyHistogram
+    {
+    public:
+        LatencyHistogram() : counts_(kBucketCount, 0) {}
+
+        void record(std::uint64_t value)
+        {
+            ++counts_[indexOf(value)];
+            ++total_;
+            sum_ += value;
+            max_ = std::max(max_, value);
+        }
+
+        void merge(const LatencyHistogram& other)
+        {
+            for (std::size_t i = 0; i < kBucketCount; ++i)
+                counts_[i] += other.counts_[i];
+            total_ += other.total_;
+            sum_ += other.sum_;
+            max_ = std::max(max_, other.max_);
+        }
+
+        /// @param percentile 0~100
+        std::uint64_t percentile(double percentile) const
+        {
+            if (total_ == 0)
+                return 0;
+            const auto rank = static_cast<std::uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(total_)));
+            const std::uint64_t target = std::max<std::uint64_t>(rank, 1);
+            std::uint64_t seen = 0;
+            for (std::size_t i = 0; i < kBucketCount; ++i)
+            {
+                seen += counts_[i];
+                if (seen >= target)
+                    return std::min(upperBound(i), max_);
+            }
+            return max_;
+        }
+
+        std::uint64_t count() const { return total_; }
+        std::uint64_t max() const { return max_; }
+        double mean() const { return total_ ? static_cast<double>(sum_) / static_cast<double>(total_) : 0.0; }
+
+    private:
+        static constexpr unsigned kSubBits = 7;
+        static constexpr std::uint64_t kSubCount = 1ull << kSubBits;
+        static constexpr std::size_t kBucketCount = kSubCount + (64 - kSubBits) * kSubCount;
+
+        static unsigned highestBit(std::uint64_t value)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#else
+            unsigned bit = 0;
+            while (value >>= 1)
+                ++bit;
+            return bit;
+#endif
+        }
+
+        static std::size_t indexOf(std::uint64_t value)
+        {
+            if (value < kSubCount)
+                return static_cast<std::size_t>(value);
+            const unsigned shift = highestBit(value) - kSubBits;
+            const std::uint64_t top = value >> shift;// [kSubCount, 2 * kSubCount)
+            return static_cast<std::size_t>(kSubCount + shift * kSubCount + (top - kSubCount));
+        }
+
+        static std::uint64_t upperBound(std::size_t index)
+        {
+            if (index < kSubCount)
+                return index;
+            const std::uint64_t shift = (index - kSubCount) / kSubCount;
+            const std::uint64_t top = kSubCount + (index - kSubCount) % kSubCount;
+            return ((top + 1) << shift) - 1;
+        }
+
+        std::vector<std::uint64_t> counts_;
+        std::uint64_t total_ = 0;
+        std::uint64_t sum_ = 0;
+        std::uint64_t max_ = 0;
+    };
+}// namespace Bench
+
+#endif// LOGGER_BENCH_LATENCY_HISTOGRAM_H
@@ -0,0 +1,180 @@
+/*************************************************
+  * 描述：Logger 性能基准入口
+  *
+  * 用法：Logger_bench [套件名...] [--iterations N] [--threads 1,2,4,...] [--json 文件路径]
+  *                   [--configs a.yaml,b.yaml] [--profiles steady,bursty,threads] [--rate N] [--burst N]
+  *                   [--clock steady|tsc] [--csv 文件路径]
+  *  - dispatch：单个参数的文本化开销（旧版 unordered_map + std::function 分发 vs 当前实现）
+  *  - numbers：整数/浮点数格式化开销（std::to_string vs 当前的数值格式化内核）
+  *  - utf8：宽字符串转 UTF-8 开销（std::wstring_convert vs 当前的转码实现）
+  *  - callback：回调开销（LogMsg 回调 vs 零拷贝视图回调，是否读取格式化文本）
+  *  - scaling：1~64 线程同时打日志时获取当前 logger 的开销（shared_ptr 拷贝 vs epoch）与端到端吞吐
+  *  - async_queue：1~64 线程同时打异步日志时共享队列（shared）与按线程分队列（per_thread）的吞吐
+  *  - overhead：LOG_INFO（1/3/8 个参数）与被过滤的 LOG_TRACE 相对直接调用 spdlog::logger 的开销，
+  *    覆盖同步/异步、null/文件/回调 sink 与 1~64 线程，--json 时另输出 JSON
+  *  - latency：逐条计时 LOG_INFO，按 YAML 配置 × 负载（匀速/突发/多线程）输出 p50/p99/p99.9/max，--csv 时另输出 CSV
+  *
+  * File：main.cpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#include "bench_common.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Suite
+    {
+        const char* name;
+        int (*run)(const Bench::Options&);
+    };
+
+    const Suite kSuites[] = {
+            {"dispatch", &Bench::runDispatchBench},
+            {"numbers", &Bench::runNumbersBench},
+            {"utf8", &Bench::runUtf8Bench},
+            {"scaling", &Bench::runScalingBench},
+            {"callback", &Bench::runCallbackBench},
+            {"async_queue", &Bench::runAsyncQueueBench},
+            {"overhead", &Bench::runOverheadBench},
+            {"latency", &Bench::runLatencyBench},
+    };
+
+    void printUsage()
+    {
+        std::cerr << "用法: Logger_bench [套件名...] [--iterations N] [--threads 1,2,4,...] [--json 文件路径]\n"
+                     "                    [--configs a.yaml,b.yaml] [--profiles steady,bursty,threads] [--rate N] [--burst N]\n"
+                     "                    [--clock steady|tsc] [--csv 文件路径]\n可用套件:";
+        for (const auto& suite: kSuites)
+        {
+            std::cerr << ' ' << suite.name;
+        }
+        std::cerr << std::endl;
+    }
+
+    std::vector<std::string> splitList(const std::string& text)
+    {
+        std::vector<std::string> items;
+        std::stringstream list(text);
+        std::string item;
+        while (std::getline(list, item, ','))
+        {
+            if (!item.empty())
+                items.push_back(item);
+        }
+        return items;
+    }
+}// namespace
+
+std::string Bench::writeNullSinkConfig(const std::string& name, bool async, const std::string& queue, int queueSize)
+{
+    const std::string path = "./bench_" + name + ".yaml";
+    std::ofstream f(path);
+    f << "log_config:\n"
+      << "  logger:\n"
+      << "    name: bench-" << name << "\n"
+      << "    debug_level: trace\n"
+      << "    release_level: trace\n"
+      << "    flush_on: off\n"
+      << "    pattern: \"[%Y-%m-%d %H:%M:%S.%e][%n][%l][thread %t]%v\"\n"
+      << "    async: " << (async ? "true" : "false") << "\n"
+      << "    async_queue_size: " << queueSize << "\n"
+      << "    async_queue: " << queue << "\n"
+      << "  showCodeLine:\n"
+      << "    trace: false\n    debug: false\n    info: false\n"
+      << "    warn: false\n    error: false\n    critical: false\n"
+      << "  sinks:\n"
+      << "    - type: null\n"
+      << "      level: trace\n";
+    return path;
+}
+
+int main(int argc, char* argv[])
+{
+    Bench::Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc)
+        {
+            options.iterations = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            options.threads.clear();
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ','))
+            {
+                const int n = std::atoi(item.c_str());
+                if (n > 0)
+                    options.threads.push_back(n);
+            }
+        }
+        else if (arg == "--json" && i + 1 < argc)
+        {
+            options.json = argv[++i];
+        }
+        else if (arg == "--configs" && i + 1 < argc)
+        {
+            options.configs = splitList(argv[++i]);
+        }
+        else if (arg == "--profiles" && i + 1 < argc)
+        {
+            options.profiles = splitList(argv[++i]);
+        }
+        else if (arg == "--rate" && i + 1 < argc)
+        {
+            options.rate = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--burst" && i + 1 < argc)
+        {
+            options.burst = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--clock" && i + 1 < argc)
+        {
+            options.tsc = std::string(argv[++i]) == "tsc";
+        }
+        else if (arg == "--csv" && i + 1 < argc)
+        {
+            options.csv = argv[++i];
+        }
+        else if (arg == "-h" || arg == "--help")
+        {
+            printUsage();
+            return 0;
+        }
+        else
+        {
+            options.suites.push_back(arg);
+        }
+    }
+
+    int rc = 0;
+    bool matched = false;
+    for (const auto& suite: kSuites)
+    {
+        if (!options.suites.empty() &&
+            std::find(options.suites.begin(), options.suites.end(), suite.name) == options.suites.end())
+        {
+            continue;
+        }
+        matched = true;
+        std::cout << "==== " << suite.name << " ====" << std::endl;
+        rc |= suite.run(options);
+    }
+    if (!matched)
+    {
+        printUsage();
+        return 1;
+    }
+    return rc;
+}
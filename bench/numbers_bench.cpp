@@ -0,0 +1,83 @@
+/*************************************************
+  * 描述：数值格式化基准
+  *
+  * 对比单个数值写入缓冲的开销（ns/数值）：
+  *  - to_string：旧版的 std::to_string + append（float 为 6 位定点小数）
+  *  - kernel：当前的 appendInteger（两位查表）/ appendFloating（最短往返 to_chars）
+  *  - fixed(3)：appendFloating 定点 3 位小数（float_precision: 3）
+  *
+  * File：numbers_bench.cpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#include "bench_common.h"
+
+#include <logger/anytostring.hpp>
+
+#include <cstdio>
+#include <random>
+
+namespace
+{
+    // 预生成的一批数值，避免每次都格式化同一个常量
+    template<typename T>
+    std::vector<T> makeValues(T low, T high)
+    {
+        std::mt19937_64 rng(42);
+        std::vector<T> values(1024);
+        for (auto& value: values)
+        {
+            if constexpr (std::is_floating_point_v<T>)
+                value = std::uniform_real_distribution<T>(low, high)(rng);
+            else
+                value = std::uniform_int_distribution<T>(low, high)(rng);
+        }
+        return values;
+    }
+
+    template<typename T, typename Fn>
+    double measure(const std::vector<T>& values, std::uint64_t iterations, Fn&& fn)
+    {
+        std::string out;
+        out.reserve(64);
+        const auto start = Bench::Clock::now();
+        for (std::uint64_t i = 0; i < iterations; ++i)
+        {
+            out.clear();
+            fn(out, values[i & (values.size() - 1)]);
+            Bench::doNotOptimize(out);
+        }
+        return Bench::nsPerOp(Bench::Clock::now() - start, iterations);
+    }
+
+    template<typename T>
+    void benchValues(const char* name, const std::vector<T>& values, std::uint64_t iterations)
+    {
+        const double legacy = measure(values, iterations, [](std::string& out, T v) { out.append(std::to_string(v)); });
+        const double kernel = measure(values, iterations, [](std::string& out, T v) { LoggerUtil::appendArg(out, v); });
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            const double fixed = measure(values, iterations, [](std::string& out, T v) { LoggerUtil::appendArg(out, v, 3); });
+            std::printf("%-18s %10.1f %10.1f %10.1f\n", name, legacy, kernel, fixed);
+        }
+        else
+        {
+            std::printf("%-18s %10.1f %10.1f %10s\n", name, legacy, kernel, "-");
+        }
+    }
+}// namespace
+
+int Bench::runNumbersBench(const Options& options)
+{
+    const std::uint64_t n = options.iterations;
+    std::printf("%-18s %10s %10s %10s   (ns/数值)\n", "value", "to_string", "kernel", "fixed(3)");
+    benchValues("int [0,100)", makeValues<int>(0, 99), n);
+    benchValues("int [-1e6,1e6]", makeValues<int>(-1000000, 1000000), n);
+    benchValues("int64 full", makeValues<long long>(INT64_MIN, INT64_MAX), n);
+    benchValues("uint64 full", makeValues<unsigned long long>(0, UINT64_MAX), n);
+    benchValues("float [0,1000)", makeValues<float>(0.0f, 1000.0f), n);
+    benchValues("double [0,1000)", makeValues<double>(0.0, 1000.0), n);
+    benchValues("double [-1e9,1e9]", makeValues<double>(-1e9, 1e9), n);
+    return 0;
+}
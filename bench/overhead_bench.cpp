@@ -0,0 +1,299 @@
+/*************************************************
+  * 描述：封装开销基准（Logger vs 直接调用 spdlog::logger）
+  *
+  * 按 同步/异步 × sink × 调用形式 × 线程数 逐项测每次调用的耗时（ns/次，按单线程计时折算），
+  * 同一组合下再用等价的裸 spdlog::logger 测一次，给出两者之差与比值：
+  *  - 调用形式：LOG_INFO 带 1 / 3 / 8 个混合类型参数（字符串、整数、浮点、std::string、bool），
+  *    被 logger 级别过滤掉的 LOG_TRACE；裸 spdlog 用输出相同文本的格式串
+  *  - sink：null、basic_file_sink_mt（每次测量后删除）、null + 只读 level 的回调
+  *    （Logger::addCallBack 的视图回调 vs spdlog 的 callback_sink_mt）
+  *  - 异步：共享队列（1 个 worker，容量 65536，队列满时阻塞），只计调用方看到的入队耗时，
+  *    排空不计时；裸 spdlog 使用同样设置的 thread_pool + async_logger
+  * 每一项都重新加载配置 / 新建 logger，测量前先单线程预热
+  *
+  * --json <path> 时另把全部结果写成 JSON（每项一条记录），便于跟踪回归
+  *
+  * File：overhead_bench.cpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#include "bench_common.h"
+
+#include <logger/logger.h>
+
+#include <spdlog/async.h>
+#include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/sinks/callback_sink.h>
+#include <spdlog/sinks/null_sink.h>
+#include <spdlog/version.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr int kQueueSize = 65536;
+    constexpr std::uint64_t kWarmUp = 1000;
+    constexpr const char* kPattern = "[%Y-%m-%d %H:%M:%S.%e][%n][%l][thread %t]%v";
+    constexpr const char* kFilePath = "./bench_overhead.log";
+
+    enum class Call
+    {
+        Info1,
+        Info3,
+        Info8,
+        TraceFiltered,
+    };
+
+    struct CallName
+    {
+        Call call;
+        const char* name;
+    };
+
+    const CallName kCalls[] = {
+            {Call::Info1, "info_1arg"},
+            {Call::Info3, "info_3arg"},
+            {Call::Info8, "info_8arg"},
+            {Call::TraceFiltered, "trace_filtered"},
+    };
+
+    const char* const kSinks[] = {"null", "file", "callback"};
+
+    struct Result
+    {
+        bool async = false;
+        std::string sink;
+        std::string call;
+        int threads = 0;
+        double logger = 0; // ns/次
+        double spdlog = 0; // ns/次
+    };
+
+    // 两边输出相同的文本，例如 "request 12 user alice latency 3.25 ok true"
+    void callLogger(Call call, std::uint64_t i, const std::string& user)
+    {
+        switch (call)
+        {
+            case Call::Info1:
+                LOG_INFO("overhead bench message");
+                break;
+            case Call::Info3:
+                LOG_INFO(i, " value ", 0.5);
+                break;
+            case Call::Info8:
+                LOG_INFO("request ", i, " user ", user, " latency ", 3.25, " ok ", true);
+                break;
+            case Call::TraceFiltered:
+                LOG_TRACE(i, " value ", 0.5);
+                break;
+        }
+    }
+
+    void callSpdlog(spdlog::logger& logger, Call call, std::uint64_t i, const std::string& user)
+    {
+        switch (call)
+        {
+            case Call::Info1:
+                logger.info("overhead bench message");
+                break;
+            case Call::Info3:
+                logger.info("{} value {}", i, 0.5);
+                break;
+            case Call::Info8:
+                logger.info("request {} user {} latency {} ok {}", i, user, 3.25, true);
+                break;
+            case Call::TraceFiltered:
+                logger.trace("{} value {}", i, 0.5);
+                break;
+        }
+    }
+
+    template<typename Fn>
+    double timeCalls(int threads, std::uint64_t perThread, Fn&& fn)
+    {
+        const std::string user = "alice";
+        for (std::uint64_t i = 0; i < kWarmUp; ++i)
+            fn(i, user);
+        const auto elapsed = Bench::runThreads(threads, [&](int) {
+            for (std::uint64_t i = 0; i < perThread; ++i)
+                fn(i, user);
+        });
+        return Bench::nsPerOp(elapsed * threads, perThread * threads);
+    }
+
+    std::string writeConfig(bool async, const std::string& sink)
+    {
+        const std::string path = "./bench_overhead.yaml";
+        std::ofstream f(path);
+        f << "log_config:\n"
+          << "  logger:\n"
+          << "    name: bench-overhead\n"
+          << "    debug_level: info\n"
+          << "    release_level: info\n"
+          << "    flush_on: off\n"
+          << "    pattern: \"" << kPattern << "\"\n"
+          << "    async: " << (async ? "true" : "false") << "\n"
+          << "    async_queue_size: " << kQueueSize << "\n"
+          << "    async_thread_count: 1\n"
+          << "    async_overflow_policy: block\n"
+          << "  showCodeLine:\n"
+          << "    trace: false\n    debug: false\n    info: false\n"
+          << "    warn: false\n    error: false\n    critical: false\n"
+          << "  sinks:\n";
+        if (sink == "file")
+        {
+            f << "    - type: basic_file_sink_mt\n"
+              << "      level: trace\n"
+              << "      file_path: " << kFilePath << "\n"
+              << "      truncate: true\n";
+        }
+        else
+        {
+            f << "    - type: null\n"
+              << "      level: trace\n";
+        }
+        return path;
+    }
+
+    double measureLogger(bool async, const std::string& sink, Call call, int threads, std::uint64_t perThread)
+    {
+        Logger::setConfigPath(writeConfig(async, sink), false);
+        long levels = 0;
+        std::string sinkId;
+        if (sink == "callback")
+        {
+            sinkId = Logger::addCallBack([&](const LogMsgView& view) { levels += static_cast<int>(view.level); },
+                                         LogLevel::Trace);
+        }
+        const double ns = timeCalls(threads, perThread, [&](std::uint64_t i, const std::string& user) {
+            callLogger(call, i, user);
+        });
+        if (!sinkId.empty())
+            Logger::removeCallBack(sinkId);
+        Logger::shutdown();// 排空异步队列
+        Bench::doNotOptimize(levels);
+        std::filesystem::remove(kFilePath);
+        return ns;
+    }
+
+    double measureSpdlog(bool async, const std::string& sink, Call call, int threads, std::uint64_t perThread)
+    {
+        long levels = 0;
+        std::vector<spdlog::sink_ptr> sinks;
+        if (sink == "file")
+        {
+            sinks.push_back(std::make_shared<spdlog::sinks::basic_file_sink_mt>(kFilePath, true));
+        }
+        else
+        {
+            sinks.push_back(std::make_shared<spdlog::sinks::null_sink_mt>());
+            if (sink == "callback")
+            {
+                sinks.push_back(std::make_shared<spdlog::sinks::callback_sink_mt>(
+                        [&](const spdlog::details::log_msg& msg) { levels += static_cast<int>(msg.level); }));
+            }
+        }
+
+        std::shared_ptr<spdlog::details::thread_pool> pool;
+        std::shared_ptr<spdlog::logger> logger;
+        if (async)
+        {
+            pool = std::make_shared<spdlog::details::thread_pool>(kQueueSize, 1);
+            logger = std::make_shared<spdlog::async_logger>("bench-overhead", sinks.begin(), sinks.end(), pool,
+                                                            spdlog::async_overflow_policy::block);
+        }
+        else
+        {
+            logger = std::make_shared<spdlog::logger>("bench-overhead", sinks.begin(), sinks.end());
+        }
+        logger->set_pattern(kPattern);
+        logger->set_level(spdlog::level::info);
+        logger->flush_on(spdlog::level::off);
+
+        const double ns = timeCalls(threads, perThread, [&](std::uint64_t i, const std::string& user) {
+            callSpdlog(*logger, call, i, user);
+        });
+        logger.reset();
+        pool.reset();// 析构时排空队列并等待 worker 退出
+        Bench::doNotOptimize(levels);
+        std::filesystem::remove(kFilePath);
+        return ns;
+    }
+
+    bool writeJson(const std::string& path, const Bench::Options& options, const std::vector<Result>& results)
+    {
+        std::ofstream f(path, std::ios::out | std::ios::trunc);
+        f << "{\n"
+          << "  \"suite\": \"overhead\",\n"
+          << "  \"unit\": \"ns/call\",\n"
+          << "  \"spdlog_version\": \"" << SPDLOG_VER_MAJOR << "." << SPDLOG_VER_MINOR << "." << SPDLOG_VER_PATCH
+          << "\",\n"
+          << "  \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n"
+          << "  \"iterations\": " << options.iterations << ",\n"
+          << "  \"results\": [\n";
+        char line[512];
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& r = results[i];
+            std::snprintf(line, sizeof(line),
+                          "    {\"mode\": \"%s\", \"sink\": \"%s\", \"call\": \"%s\", \"threads\": %d, "
+                          "\"logger_ns\": %.2f, \"spdlog_ns\": %.2f, \"overhead_ns\": %.2f, \"ratio\": %.3f}%s\n",
+                          r.async ? "async" : "sync", r.sink.c_str(), r.call.c_str(), r.threads, r.logger, r.spdlog,
+                          r.logger - r.spdlog, r.spdlog > 0 ? r.logger / r.spdlog : 0.0,
+                          i + 1 < results.size() ? "," : "");
+            f << line;
+        }
+        f << "  ]\n}\n";
+        return static_cast<bool>(f);
+    }
+}// namespace
+
+int Bench::runOverheadBench(const Options& options)
+{
+    std::printf("CPU 核数: %u\n", std::thread::hardware_concurrency());
+    std::printf("%-6s %-9s %-8s %-15s %12s %12s %12s %8s\n", "mode", "sink", "threads", "call", "Logger(ns)",
+                "spdlog(ns)", "overhead(ns)", "ratio");
+
+    std::vector<Result> results;
+    for (const bool async: {false, true})
+    {
+        for (const char* sink: kSinks)
+        {
+            for (const int threads: options.threads)
+            {
+                const std::uint64_t perThread = options.iterations / 8 / threads + 1;
+                for (const auto& call: kCalls)
+                {
+                    Result r;
+                    r.async = async;
+                    r.sink = sink;
+                    r.call = call.name;
+                    r.threads = threads;
+                    r.logger = measureLogger(async, sink, call.call, threads, perThread);
+                    r.spdlog = measureSpdlog(async, sink, call.call, threads, perThread);
+                    std::printf("%-6s %-9s %-8d %-15s %12.1f %12.1f %12.1f %8.2f\n", async ? "async" : "sync", sink,
+                                threads, call.name, r.logger, r.spdlog, r.logger - r.spdlog,
+                                r.spdlog > 0 ? r.logger / r.spdlog : 0.0);
+                    results.push_back(std::move(r));
+                }
+            }
+        }
+    }
+
+    if (!options.json.empty())
+    {
+        if (!writeJson(options.json, options, results))
+        {
+            std::fprintf(stderr, "写入 JSON 结果失败: %s\n", options.json.c_str());
+            return 1;
+        }
+        std::printf("JSON 结果: %s\n", options.json.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+/*************************************************
+  * 描述：多线程扩展性基准
+  *
+  *  - acquire：每次日志获取当前 logger 的开销（ns/次，按单线程计时折算）
+  *      shared_ptr：旧实现，拷贝一份 shared_ptr（共享引用计数上两次原子读改写）
+  *      epoch：当前实现，EpochGuard + 原子读裸指针（只写本线程独占的缓存行）
+  *  - logger：端到端 LOG_INFO 吞吐（同步 logger + null sink，总条数/秒）
+  *
+  * 线程数超过 CPU 核数时结果主要反映调度开销，缓存行争抢只有在多核上才能体现
+  *
+  * File：scaling_bench.cpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#include "bench_common.h"
+#include "epoch.hpp"
+
+#include <logger/logger.h>
+
+#include <cstdio>
+#include <memory>
+
+namespace
+{
+    struct Payload
+    {
+        int value = 1;
+    };
+
+    double acquireShared(int threads, std::uint64_t perThread)
+    {
+        const auto shared = std::make_shared<Payload>();
+        const auto elapsed = Bench::runThreads(threads, [&](int) {
+            long sum = 0;
+            for (std::uint64_t i = 0; i < perThread; ++i)
+            {
+                const std::shared_ptr<Payload> copy = shared;
+                sum += copy->value;
+            }
+            Bench::doNotOptimize(sum);
+        });
+        return Bench::nsPerOp(elapsed * threads, perThread * threads);
+    }
+
+    double acquireEpoch(int threads, std::uint64_t perThread)
+    {
+        Payload payload;
+        std::atomic<Payload*> active{&payload};
+        const auto elapsed = Bench::runThreads(threads, [&](int) {
+            long sum = 0;
+            for (std::uint64_t i = 0; i < perThread; ++i)
+            {
+                EpochGuard guard;
+                sum += active.load(std::memory_order_acquire)->value;
+            }
+            Bench::doNotOptimize(sum);
+        });
+        return Bench::nsPerOp(elapsed * threads, perThread * threads);
+    }
+
+    double loggerThroughput(int threads, std::uint64_t perThread)
+    {
+        const auto elapsed = Bench::runThreads(threads, [&](int tid) {
+            for (std::uint64_t i = 0; i < perThread; ++i)
+            {
+                LOG_INFO("scaling ", tid, " msg ", i, " value ", 0.5);
+            }
+        });
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        return seconds > 0 ? static_cast<double>(perThread * threads) / seconds : 0.0;
+    }
+}// namespace
+
+int Bench::runScalingBench(const Options& options)
+{
+    Logger::setConfigPath(writeNullSinkConfig("scaling", false), false);
+    std::printf("CPU 核数: %u\n", std::thread::hardware_concurrency());
+    std::printf("%-8s %16s %12s %18s\n", "threads", "shared_ptr(ns)", "epoch(ns)", "LOG_INFO(msg/s)");
+    for (const int threads: options.threads)
+    {
+        const std::uint64_t perThread = options.iterations / threads + 1;
+        const double shared = acquireShared(threads, perThread);
+        const double epoch = acquireEpoch(threads, perThread);
+        const double throughput = loggerThroughput(threads, perThread / 4 + 1);
+        std::printf("%-8d %16.2f %12.2f %18.0f\n", threads, shared, epoch, throughput);
+    }
+    Logger::shutdown();
+    return 0;
+}
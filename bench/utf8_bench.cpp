@@ -0,0 +1,76 @@
+/*************************************************
+  * 描述：宽字符串转 UTF-8 基准
+  *
+  * 对比每个码元的转码开销（ns/码元）：
+  *  - codecvt：旧版的 std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>>（每次调用构造一次）
+  *  - transcoder：当前的 LoggerUtil::appendUtf8（SIMD ASCII 快速路径）
+  *
+  * File：utf8_bench.cpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#include "bench_common.h"
+
+#include <logger/wideutf8.hpp>
+
+#include <codecvt>
+#include <cstdio>
+#include <locale>
+
+namespace
+{
+    std::string legacyToUtf8(const std::wstring& wstr)
+    {
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#endif
+        std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+        return converter.to_bytes(wstr.data(), wstr.data() + wstr.size());
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+    }
+
+    template<typename Fn>
+    double measure(const std::wstring& text, std::uint64_t iterations, Fn&& fn)
+    {
+        std::string out;
+        const auto start = Bench::Clock::now();
+        for (std::uint64_t i = 0; i < iterations; ++i)
+        {
+            out.clear();
+            fn(out, text);
+            Bench::doNotOptimize(out);
+        }
+        return Bench::nsPerOp(Bench::Clock::now() - start, iterations * text.size());
+    }
+
+    void benchText(const char* name, const std::wstring& text, std::uint64_t iterations)
+    {
+        const double legacy = measure(text, iterations, [](std::string& out, const std::wstring& w) { out.append(legacyToUtf8(w)); });
+        const double fast = measure(text, iterations, [](std::string& out, const std::wstring& w) { LoggerUtil::appendUtf8(out, w); });
+        std::printf("%-20s %10.2f %12.2f\n", name, legacy, fast);
+    }
+}// namespace
+
+int Bench::runUtf8Bench(const Options& options)
+{
+    const std::uint64_t n = options.iterations / 10 + 1;
+    std::wstring ascii64;
+    for (int i = 0; i < 64; ++i) ascii64.push_back(static_cast<wchar_t>('a' + i % 26));
+    std::wstring ascii1k;
+    for (int i = 0; i < 16; ++i) ascii1k += ascii64;
+    std::wstring cjk;
+    for (int i = 0; i < 64; ++i) cjk.push_back(static_cast<wchar_t>(0x4E00 + i));
+    std::wstring mixed;
+    for (int i = 0; i < 16; ++i) mixed += L"sensor 温度=";
+
+    std::printf("%-20s %10s %12s   (ns/码元)\n", "text", "codecvt", "transcoder");
+    benchText("ascii x64", ascii64, n);
+    benchText("ascii x1024", ascii1k, n / 8 + 1);
+    benchText("cjk x64", cjk, n);
+    benchText("mixed x160", mixed, n);
+    return 0;
+}
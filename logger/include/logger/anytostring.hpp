@@ -5,115 +5,440 @@
   * Author：3029795434@qq.com
   * Date：2026/2/11
   * Update：2026/7/13 — 优化类型分发 O(1)，替换废弃 codecvt
+  *         2026/10/16 — 新增按静态类型直接追加的 appendArg 与线程局部 ScratchBuffer
+  *         2026/10/16 — std::any 分发改为就地追加（appendAny），不再逐个生成临时字符串
+  *         2026/10/16 — std::any 分发改为以 type_info 地址为键的平坦散列表 + 常用类型快速路径，
+  *                      扩充短整型、char、string_view、指针、枚举、std::chrono 时长等类型
+  *         2026/10/16 — 统一数值格式化：整数按两位查表输出，float/double 均为最短往返表示，
+  *                      可选定点小数位数（floatPrecision），全程与区域设置无关
+  *         2026/10/16 — 宽字符串改用 wideutf8.hpp 的转码（SIMD ASCII 快速路径），不再依赖 codecvt / windows.h
   * ************************************************/
 #ifndef LOGGER_ANYTOSTRING_H
 #define LOGGER_ANYTOSTRING_H
 #include <any>
 #include <charconv>
-#include <functional>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <optional>
+#include <ratio>
 #include <string>
-#include <typeindex>
-#include <unordered_map>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
 
-#ifdef _WIN32
-#include <windows.h>
-#else
-#include <codecvt>
-#include <locale>
-#endif
+#include "wideutf8.hpp"
 
 namespace LoggerUtil
 {
+    /// 线程局部的可复用格式化缓冲，稳态下日志拼接不再分配内存
+    /// 嵌套使用（如同步回调中再次打日志）时退化为独立的局部缓冲，不会覆盖外层内容
+    class ScratchBuffer
+    {
+    public:
+        ScratchBuffer()
+            : m_owner(!inUse())
+        {
+            if (m_owner)
+            {
+                inUse() = true;
+                shared().clear();
+            }
+        }
+
+        ~ScratchBuffer()
+        {
+            if (m_owner)
+            {
+                inUse() = false;
+                if (shared().capacity() > kMaxRetained)// 偶发的超长日志不长期占用线程内存
+                    std::string().swap(shared());
+            }
+        }
+
+        ScratchBuffer(const ScratchBuffer&) = delete;
+        ScratchBuffer& operator=(const ScratchBuffer&) = delete;
+
+        std::string& str() { return m_owner ? shared() : m_local; }
+
+        std::string_view view() { return str(); }
+
+    private:
+        static constexpr std::size_t kMaxRetained = 64 * 1024;
+
+        static std::string& shared()
+        {
+            thread_local std::string buffer;
+            return buffer;
+        }
+
+        static bool& inUse()
+        {
+            thread_local bool flag = false;
+            return flag;
+        }
+
+        bool m_owner;
+        std::string m_local;
+    };
+
+    /// 浮点数按最短往返表示输出（默认）；>= 0 时为定点小数位数
+    constexpr int kShortestFloat = -1;
+    constexpr int kMaxFloatPrecision = 17;
+
+    /// "00" ~ "99" 两位数字表，整数每次输出两位，除法次数减半
+    inline constexpr char kDigitPairs[] =
+            "00010203040506070809"
+            "10111213141516171819"
+            "20212223242526272829"
+            "30313233343536373839"
+            "40414243444546474849"
+            "50515253545556575859"
+            "60616263646566676869"
+            "70717273747576777879"
+            "80818283848586878889"
+            "90919293949596979899";
+
+    /// 整数直接写入 out，不经过临时 std::string
+    /// 缓冲按类型的十进制位数确定（含 gnu++17 下的 __int128），digits10 + 1 位数字外加负号
+    template<typename T>
+    inline void appendInteger(std::string& out, T value)
+    {
+        using Unsigned = std::make_unsigned_t<T>;
+        static_assert(std::numeric_limits<Unsigned>::is_specialized, "appendInteger: unsupported integer type");
+        char buf[std::numeric_limits<Unsigned>::digits10 + 2];
+        char* const end = buf + sizeof(buf);
+        char* p = end;
+
+        Unsigned u = static_cast<Unsigned>(value);
+        bool negative = false;
+        if constexpr (std::is_signed_v<T>)
+        {
+            if (value < 0)
+            {
+                negative = true;
+                u = static_cast<Unsigned>(Unsigned(0) - u);// 最小负数取反不溢出
+            }
+        }
+
+        while (u >= 100)
+        {
+            const auto pair = static_cast<unsigned>(u % 100) * 2;
+            u = static_cast<Unsigned>(u / 100);
+            p -= 2;
+            std::memcpy(p, kDigitPairs + pair, 2);
+        }
+        if (u >= 10)
+        {
+            p -= 2;
+            std::memcpy(p, kDigitPairs + static_cast<unsigned>(u) * 2, 2);
+        }
+        else
+        {
+            *--p = static_cast<char>('0' + static_cast<unsigned>(u));
+        }
+        if (negative)
+            *--p = '-';
+        out.append(p, end);
+    }
+
+    /// 浮点数写入 out：precision < 0 为最短往返表示，否则为定点小数；-0 输出为 0
+    template<typename T>
+    inline void appendFloating(std::string& out, T value, int precision = kShortestFloat)
+    {
+        if (value == 0)
+            value = 0;// 统一 -0
+        char buf[64];
+        std::to_chars_result result;
+        if (precision < 0)
+        {
+            result = std::to_chars(buf, buf + sizeof(buf), value);
+        }
+        else
+        {
+            precision = precision > kMaxFloatPrecision ? kMaxFloatPrecision : precision;
+            result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::fixed, precision);
+            if (result.ec != std::errc{})// 数值过大，定点表示放不下
+                result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::scientific, precision);
+        }
+        if (result.ec == std::errc{})
+            out.append(buf, result.ptr);
+    }
+
     inline std::string floatingNumToString(double value)
     {
-        if (value == 0.0 || value == -0.0)
-            return "0";
-
-        char buf[32];
-        auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), value);
-        if (ec != std::errc{})
-            return std::to_string(value);  // fallback
-        return std::string(buf, ptr);
+        std::string str;
+        appendFloating(str, value);
+        return str;
     }
 
-    /// 宽字符转 UTF-8（不使用已废弃的 std::codecvt）
-    inline std::string wstringToUtf8(std::wstring_view wstr)
+    inline bool appendAny(std::string& out, const std::any& data, int floatPrecision = kShortestFloat);
+
+    template<typename T>
+    struct IsDuration : std::false_type {};
+
+    template<typename Rep, typename Period>
+    struct IsDuration<std::chrono::duration<Rep, Period>> : std::true_type {};
+
+    /// 时长单位后缀，与 C++20 std::chrono 的输出格式一致（微秒用 ASCII 的 us）
+    template<typename Period>
+    inline void appendDurationSuffix(std::string& out)
     {
-        if (wstr.empty()) return {};
-#ifdef _WIN32
-        int len = WideCharToMultiByte(CP_UTF8, 0, wstr.data(), static_cast<int>(wstr.size()),
-                                      nullptr, 0, nullptr, nullptr);
-        if (len <= 0) return {};
-        std::string result(static_cast<size_t>(len), '\0');
-        WideCharToMultiByte(CP_UTF8, 0, wstr.data(), static_cast<int>(wstr.size()),
-                            result.data(), len, nullptr, nullptr);
-        return result;
-#else
-        // POSIX：C++17 标记废弃但 C++26 前仍可用
-        #pragma GCC diagnostic push
-        #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-        std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-        auto result = converter.to_bytes(wstr.data());
-        #pragma GCC diagnostic pop
-        return result;
-#endif
+        if constexpr (std::is_same_v<Period, std::nano>)
+            out.append("ns");
+        else if constexpr (std::is_same_v<Period, std::micro>)
+            out.append("us");
+        else if constexpr (std::is_same_v<Period, std::milli>)
+            out.append("ms");
+        else if constexpr (std::is_same_v<Period, std::ratio<1>>)
+            out.append("s");
+        else if constexpr (std::is_same_v<Period, std::ratio<60>>)
+            out.append("min");
+        else if constexpr (std::is_same_v<Period, std::ratio<3600>>)
+            out.append("h");
+        else if constexpr (std::is_same_v<Period, std::ratio<86400>>)
+            out.append("d");
+        else
+        {
+            out.push_back('[');
+            appendInteger(out, Period::num);
+            if constexpr (Period::den != 1)
+            {
+                out.push_back('/');
+                appendInteger(out, Period::den);
+            }
+            out.append("]s");
+        }
     }
 
-    /// O(1) 类型分发表（静态初始化一次）
-    using AnyConverter = std::function<std::optional<std::string>(const std::any&)>;
+    /// 按静态类型把单个日志参数追加到 out，不做 std::any 装箱
+    /// 未识别的类型退回 std::any + anyToString 的运行时分发，行为与旧接口一致
+    /// floatPrecision 只作用于浮点数（含浮点计数的时长），见 appendFloating
+    template<typename T>
+    inline void appendArg(std::string& out, const T& value, int floatPrecision = kShortestFloat)
+    {
+        using U = std::decay_t<T>;
+        if constexpr (std::is_same_v<U, bool>)
+        {
+            out.append(value ? "true" : "false");
+        }
+        else if constexpr (std::is_same_v<U, char>)
+        {
+            out.push_back(value);
+        }
+        else if constexpr (std::is_same_v<U, wchar_t>)
+        {
+            appendUtf8(out, std::wstring_view(&value, 1));
+        }
+        else if constexpr (std::is_integral_v<U>)// 含 int8_t/uint8_t（signed/unsigned char），按数值输出
+        {
+            appendInteger(out, value);
+        }
+        else if constexpr (std::is_same_v<U, long double>)
+        {
+            appendFloating(out, static_cast<double>(value), floatPrecision);
+        }
+        else if constexpr (std::is_floating_point_v<U>)
+        {
+            appendFloating(out, value, floatPrecision);
+        }
+        else if constexpr (std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view>)
+        {
+            out.append(value.data(), value.size());
+        }
+        else if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*>)
+        {
+            const char* const str = value;// 字符数组（字面量）先退化为指针再判空
+            if (str)
+                out.append(str);
+        }
+        else if constexpr (std::is_same_v<U, std::wstring> || std::is_same_v<U, std::wstring_view>)
+        {
+            appendUtf8(out, value);
+        }
+        else if constexpr (std::is_same_v<U, const wchar_t*> || std::is_same_v<U, wchar_t*>)
+        {
+            const wchar_t* const str = value;
+            if (str)
+                appendUtf8(out, str);
+        }
+        else if constexpr (std::is_enum_v<U>)
+        {
+            appendInteger(out, static_cast<std::underlying_type_t<U>>(value));
+        }
+        else if constexpr (IsDuration<U>::value)
+        {
+            appendArg(out, value.count(), floatPrecision);
+            appendDurationSuffix<typename U::period>(out);
+        }
+        else if constexpr (std::is_pointer_v<U>)
+        {
+            char buf[2 + sizeof(std::uintptr_t) * 2];
+            buf[0] = '0';
+            buf[1] = 'x';
+            auto [ptr, ec] = std::to_chars(buf + 2, buf + sizeof(buf), reinterpret_cast<std::uintptr_t>(value), 16);
+            if (ec == std::errc{})
+                out.append(buf, ptr);
+        }
+        else if constexpr (std::is_same_v<U, std::any>)
+        {
+            appendAny(out, value, floatPrecision);
+        }
+        else
+        {
+            appendAny(out, std::any(value), floatPrecision);
+        }
+    }
+
+    /// std::any 分发项：就地追加到 out，不产生临时字符串
+    using AnyAppender = void (*)(std::string& out, const std::any& data, int floatPrecision);
+
+    template<typename T>
+    inline void appendAnyAs(std::string& out, const std::any& data, int floatPrecision)
+    {
+        appendArg(out, *std::any_cast<T>(&data), floatPrecision);// 指针形式的 any_cast 不拷贝被持有的对象
+    }
 
-    inline const std::unordered_map<std::type_index, AnyConverter>& getConverters()
+    /**
+     * std::any 分发表：以 type_info 地址为键的开放寻址平坦表，首次使用时构建一次，之后只读
+     * 同一类型在不同模块中可能存在多份 type_info，地址未命中时再按类型相等逐项比较
+     */
+    class AnyDispatchTable
     {
-        static const std::unordered_map<std::type_index, AnyConverter> map = {
-            {std::type_index(typeid(std::string)),
-             [](const std::any& a) -> std::optional<std::string> { return std::any_cast<std::string>(a); }},
-            {std::type_index(typeid(const char*)),
-             [](const std::any& a) -> std::optional<std::string> { return std::any_cast<const char*>(a); }},
-            {std::type_index(typeid(char*)),
-             [](const std::any& a) -> std::optional<std::string> { return std::any_cast<char*>(a); }},
-            {std::type_index(typeid(int)),
-             [](const std::any& a) -> std::optional<std::string> { return std::to_string(std::any_cast<int>(a)); }},
-            {std::type_index(typeid(unsigned int)),
-             [](const std::any& a) -> std::optional<std::string> { return std::to_string(std::any_cast<unsigned int>(a)); }},
-            {std::type_index(typeid(long)),
-             [](const std::any& a) -> std::optional<std::string> { return std::to_string(std::any_cast<long>(a)); }},
-            {std::type_index(typeid(long long)),
-             [](const std::any& a) -> std::optional<std::string> { return std::to_string(std::any_cast<long long>(a)); }},
-            {std::type_index(typeid(float)),
-             [](const std::any& a) -> std::optional<std::string> { return std::to_string(std::any_cast<float>(a)); }},
-            {std::type_index(typeid(double)),
-             [](const std::any& a) -> std::optional<std::string> { return floatingNumToString(std::any_cast<double>(a)); }},
-            {std::type_index(typeid(size_t)),
-             [](const std::any& a) -> std::optional<std::string> { return std::to_string(std::any_cast<size_t>(a)); }},
-            {std::type_index(typeid(uint64_t)),
-             [](const std::any& a) -> std::optional<std::string> { return std::to_string(std::any_cast<uint64_t>(a)); }},
-            {std::type_index(typeid(bool)),
-             [](const std::any& a) -> std::optional<std::string> { return std::any_cast<bool>(a) ? std::string("true") : std::string("false"); }},
-            {std::type_index(typeid(std::wstring)),
-             [](const std::any& a) -> std::optional<std::string> { return wstringToUtf8(std::any_cast<std::wstring>(a)); }},
-            {std::type_index(typeid(wchar_t*)),
-             [](const std::any& a) -> std::optional<std::string> { return wstringToUtf8(std::any_cast<wchar_t*>(a)); }},
-            {std::type_index(typeid(const wchar_t*)),
-             [](const std::any& a) -> std::optional<std::string> { return wstringToUtf8(std::any_cast<const wchar_t*>(a)); }},
+    public:
+        static const AnyDispatchTable& instance()
+        {
+            static const AnyDispatchTable table;
+            return table;
+        }
+
+        AnyAppender find(const std::type_info& type) const
+        {
+            for (std::size_t i = slotOf(&type);; i = (i + 1) & (kSlots - 1))
+            {
+                if (m_slots[i].type == &type)
+                    return m_slots[i].append;
+                if (!m_slots[i].type)
+                    break;
+            }
+            for (const auto& slot: m_slots)
+            {
+                if (slot.type && *slot.type == type)
+                    return slot.append;
+            }
+            return nullptr;
+        }
+
+    private:
+        static constexpr std::size_t kSlots = 128;// 2 的幂，装载率保持在 1/3 以下
+
+        struct Slot
+        {
+            const std::type_info* type = nullptr;
+            AnyAppender append = nullptr;
         };
-        return map;
+
+        static std::size_t slotOf(const std::type_info* type)
+        {
+            // type_info 对象按指针大小对齐，低位恒为 0，乘法散列后取高位
+            const auto key = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(type));
+            return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> 57) & (kSlots - 1);
+        }
+
+        template<typename T>
+        void add()
+        {
+            std::size_t i = slotOf(&typeid(T));
+            while (m_slots[i].type && m_slots[i].type != &typeid(T))
+                i = (i + 1) & (kSlots - 1);
+            m_slots[i] = {&typeid(T), &appendAnyAs<T>};
+        }
+
+        AnyDispatchTable()
+        {
+            add<std::string>();
+            add<std::string_view>();
+            add<const char*>();
+            add<char*>();
+            add<std::wstring>();
+            add<std::wstring_view>();
+            add<const wchar_t*>();
+            add<wchar_t*>();
+            add<bool>();
+            add<char>();
+            add<signed char>();
+            add<unsigned char>();
+            add<wchar_t>();
+            add<short>();
+            add<unsigned short>();
+            add<int>();
+            add<unsigned int>();
+            add<long>();
+            add<unsigned long>();
+            add<long long>();
+            add<unsigned long long>();
+            add<float>();
+            add<double>();
+            add<long double>();
+            add<const void*>();
+            add<void*>();
+            add<std::chrono::nanoseconds>();
+            add<std::chrono::microseconds>();
+            add<std::chrono::milliseconds>();
+            add<std::chrono::seconds>();
+            add<std::chrono::minutes>();
+            add<std::chrono::hours>();
+        }
+
+        Slot m_slots[kSlots];
+    };
+
+    /// std::any 按运行时类型追加到 out；空值、nullptr 或不支持的类型返回 false，out 不变
+    inline bool appendAny(std::string& out, const std::any& data, int floatPrecision)
+    {
+        if (!data.has_value())
+            return false;
+
+        // 最常见的几种类型直接比较 type_info 地址，不进入查表
+        const std::type_info& type = data.type();
+        if (&type == &typeid(const char*))
+        {
+            appendAnyAs<const char*>(out, data, floatPrecision);
+            return true;
+        }
+        if (&type == &typeid(std::string))
+        {
+            appendAnyAs<std::string>(out, data, floatPrecision);
+            return true;
+        }
+        if (&type == &typeid(int))
+        {
+            appendAnyAs<int>(out, data, floatPrecision);
+            return true;
+        }
+        if (&type == &typeid(double))
+        {
+            appendAnyAs<double>(out, data, floatPrecision);
+            return true;
+        }
+
+        if (&type == &typeid(std::nullptr_t))
+            return false;
+        const AnyAppender append = AnyDispatchTable::instance().find(type);
+        if (!append)
+            return false;
+        append(out, data, floatPrecision);
+        return true;
     }
 
     inline std::optional<std::string> anyToString(const char* /*fileName*/, int /*fileLine*/,
                                                   const char* /*function*/, const std::any& data)
     {
-        if (!data.has_value())
-            return std::nullopt;
-        if (data.type() == typeid(nullptr))
+        std::string str;
+        if (!appendAny(str, data))
             return std::nullopt;
-
-        auto& converters = getConverters();
-        auto it = converters.find(std::type_index(data.type()));
-        if (it != converters.end())
-            return it->second(data);
-
-        return std::nullopt;
+        return str;
     }
 }
 
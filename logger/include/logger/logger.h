@@ -10,9 +10,18 @@
 #define LOGGER_H
 
 #include <any>
+#include "anytostring.hpp"
 #include "export.h"
+#include "logrecord.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
 
 #ifndef QT_NO_DEBUG// 如果debug模式，则应声明DEBUG宏，用来判断是否启用日志输出
 #define DEBUG
@@ -40,9 +49,250 @@ struct LogMsg
 	std::string msg;
 };
 
+/**
+ * 回调参数的零拷贝视图，字段指向库内部缓冲，仅在回调执行期间有效
+ * 需要保存时调用 toLogMsg() 拷贝
+ */
+struct LogMsgView
+{
+	/// 按 pattern 格式化整条日志的函数，由库在构造视图时绑定
+	using FormatFn = std::string_view (*)(const void* context);
+
+	std::string_view fileName;
+	int codeLine = 0;
+	std::string_view funcName;
+	std::size_t threadId = 0;
+	LogLevel level = LogLevel::Trace;
+	std::string_view msg;
+	std::chrono::system_clock::time_point time;
+	std::string_view loggerName;
+
+	/**
+	 * 按 pattern 格式化后的整条日志，首次访问时才格式化并缓存
+	 * 只读取 msg / level 等字段的回调完全跳过 pattern 格式化
+	 */
+	std::string_view msgFormatted() const
+	{
+		if (!m_formattedReady)
+		{
+			if (m_format)
+				m_formatted = m_format(m_formatContext);
+			m_formattedReady = true;
+		}
+		return m_formatted;
+	}
+
+	/// 绑定延迟格式化函数（库内部使用），context 在回调执行期间有效
+	void bindFormatter(FormatFn format, const void* context)
+	{
+		m_format = format;
+		m_formatContext = context;
+		m_formattedReady = false;
+	}
+
+	/// 直接设置已格式化好的文本（库内部使用）
+	void setFormatted(std::string_view formatted)
+	{
+		m_format = nullptr;
+		m_formatted = formatted;
+		m_formattedReady = true;
+	}
+
+	/// 拷贝到 out（复用 out 中字符串已有的容量），会触发格式化
+	void toLogMsg(LogMsg& out) const
+	{
+		out.fileName.assign(fileName.data(), fileName.size());
+		out.codeLine = std::to_string(codeLine);
+		out.funcName.assign(funcName.data(), funcName.size());
+		out.threadId = std::to_string(threadId);
+		out.level = level;
+		const std::string_view formatted = msgFormatted();
+		out.msgFormatted.assign(formatted.data(), formatted.size());
+		out.msg.assign(msg.data(), msg.size());
+	}
+
+	LogMsg toLogMsg() const
+	{
+		LogMsg out;
+		toLogMsg(out);
+		return out;
+	}
+
+private:
+	FormatFn m_format = nullptr;
+	const void* m_formatContext = nullptr;
+	mutable std::string_view m_formatted;
+	mutable bool m_formattedReady = false;
+};
+
+/**
+ * 一批日志，元素在内存中连续、按输出顺序排列，仅在回调执行期间有效
+ */
+struct LogMsgBatch
+{
+	const LogMsgView* data = nullptr;
+	std::size_t size = 0;
+
+	const LogMsgView* begin() const { return data; }
+	const LogMsgView* end() const { return data + size; }
+	const LogMsgView& operator[](std::size_t i) const { return data[i]; }
+	bool empty() const { return size == 0; }
+};
+
+/// 回调的投递方式
+enum class CallbackMode : int
+{
+	Sync = 0, // 在打日志的线程（异步 logger 下为线程池 worker）上直接调用
+	Async = 1 // 拷入回调专属的有界队列，由独立的分发线程调用
+};
+
+/// 异步回调队列满时的处理策略
+enum class CallbackOverflow : int
+{
+	DropOldest = 0,// 丢弃队列中最旧的一条，为新日志腾位置
+	DropNewest = 1,// 丢弃新日志
+	Block = 2      // 打日志的线程等待分发线程腾出位置
+};
+
+struct CallbackOptions
+{
+	CallbackMode mode = CallbackMode::Sync;
+	std::size_t queueSize = 8192;// 异步队列容量（向上取整为 2 的幂）
+	CallbackOverflow overflow = CallbackOverflow::DropOldest;
+};
+
+/**
+ * 异步日志（async: true）队列统计，针对当前配置的线程池，切换配置后重新计数
+ */
+struct AsyncStats
+{
+	bool enabled = false;          // 当前配置是否为异步模式，为 false 时其余字段均为 0
+	bool perThreadQueue = false;   // 是否为按线程分队列（async_queue: per_thread）
+	std::size_t queueCapacity = 0; // 队列容量（async_queue_size），per_thread 时为每个线程的队列容量
+	std::size_t producerQueues = 0;// per_thread 时当前的线程队列个数
+	std::size_t queueDepth = 0;    // 当前排队等待写出的日志条数
+	std::uint64_t overrunCount = 0;// overrun_oldest 策略下被新日志覆盖的最旧日志条数
+	std::uint64_t discardCount = 0;// discard_new 策略（per_thread 时含 overrun_oldest）下因队列满被丢弃的新日志条数
+	std::uint64_t batchCount = 0;  // per_thread 时 worker 已写出的批次数（写出条数 / 批次数为平均每批条数）
+};
+
+/**
+ * 单个异步 sink（sink 配置 async: true）的统计
+ * 使用具名线程池时，队列相关字段是整个线程池的数据
+ */
+struct AsyncSinkStats
+{
+	std::string sink;                        // sink 类型与序号，如 "rotating_file_mt#1"
+	std::string pool;                        // 具名线程池名称，专属队列为空
+	std::size_t queueCapacity = 0;           // 队列容量
+	std::size_t queueDepth = 0;              // 当前排队的日志条数
+	std::uint64_t overrunCount = 0;          // overrun_oldest 策略下被覆盖的日志条数
+	std::uint64_t discardCount = 0;          // discard_new 策略下被丢弃的日志条数
+	std::uint64_t enqueued = 0;              // 本 sink 提交给队列的条数（含被丢弃的）
+	std::uint64_t written = 0;               // 本 sink 已写完的条数
+	std::chrono::microseconds stallTotal{0}; // 写入与刷新的累计耗时
+	std::chrono::microseconds stallMax{0};   // 单次写入或刷新的最长耗时
+	std::chrono::microseconds currentStall{0};// 正在进行的写入已耗时，未在写入时为 0
+};
+
+/**
+ * 配置文件自动重新加载（logger.watch: true）的统计
+ */
+struct ConfigReloadStats
+{
+	std::uint64_t reloads = 0;               // 成功重新加载的次数
+	std::uint64_t failures = 0;              // 新配置加载失败的次数，失败时保留当前配置
+	std::chrono::microseconds lastLatency{0};// 最近一次从检测到文件变化到新配置生效的耗时（含防抖等待）
+	std::chrono::microseconds maxLatency{0}; // 上述耗时的最大值
+	std::string lastError;                   // 最近一次失败的原因
+	bool watching = false;                   // 当前是否在监视配置文件
+};
+
+/**
+ * 单个级别的日志条数（Logger::getStats），自进程启动起累计，切换配置不清零
+ */
+struct LevelStats
+{
+	std::uint64_t accepted = 0;// 进入库内并通过 logger 级别过滤的条数（被 LOG_* 宏内联过滤的不进入库内，不计数）
+	std::uint64_t filtered = 0;// 进入库内后被 logger 级别过滤的条数（如直接调用 Logger::info 等接口）
+	std::uint64_t dropped = 0; // 按级别：per_thread 异步队列满被丢弃的条数；LoggerStats::total 中另含不区分级别的丢弃
+	std::uint64_t written = 0; // 已交给 sink 的条数
+};
+
+/**
+ * 单个 sink 的统计，针对当前配置，切换配置后重新计数
+ * 自定义 sink（count_rotating_file_mt、daily_size_rotating_file_mt、回调）自行计数，detailed 为 true；
+ * 其余 sink 的写入 / 过滤条数由 sink 级别推算，bytes 等字段为 0
+ */
+struct SinkStats
+{
+	std::string sink;                        // sink 类型与序号（如 "count_rotating_file_mt#1"），回调为 "callback:<sinkId>"
+	std::uint64_t written = 0;               // 已写出的条数
+	std::uint64_t filtered = 0;              // 低于 sink 级别被跳过的条数
+	std::uint64_t dropped = 0;               // sink 级异步队列或异步回调队列满时丢弃的条数
+	std::uint64_t bytes = 0;                 // 已写出的字节数（回调为消息文本字节数）
+	std::uint64_t rotations = 0;             // 文件滚动次数
+	std::chrono::microseconds rotationTime{0};// 文件滚动的累计耗时
+	std::uint64_t flushes = 0;               // 刷新次数
+	bool detailed = false;                   // sink 是否自行计数
+};
+
+/**
+ * 日志系统统计（Logger::getStats），所有计数均为无锁读取的原子量
+ */
+struct LoggerStats
+{
+	std::array<LevelStats, 6> levels{};// 按 LogLevel 索引
+	LevelStats total;                  // 各级别之和；dropped 另加当前配置的 queueDropped（shared 队列）与各 sink 的 dropped
+	                                   // （sink 级异步队列、异步回调队列，按 sink 计，切换配置后重新计数）
+	std::vector<SinkStats> sinks;      // 配置中的 sink 在前，运行时添加的回调 / 流输出在后
+	bool async = false;                // 当前配置是否为异步模式，为 false 时队列字段均为 0
+	std::size_t queueDepth = 0;        // 当前异步队列深度
+	std::size_t queueHighWater = 0;    // 采样到的异步队列最大深度（worker 每处理 256 条采样一次）
+	std::uint64_t queueDropped = 0;    // 异步队列因满丢弃或覆盖的条数
+	std::uint64_t flushes = 0;         // logger 级刷新次数（flush_on 触发与显式刷新）
+};
+
+namespace LoggerUtil
+{
+	/// 编译期截取路径中的文件名部分（兼容 / 与 \ 分隔符），返回指向原字符串内部的指针
+	constexpr const char* fileBasename(const char* path)
+	{
+		const char* name = path;
+		for (const char* p = path; *p != '\0'; ++p)
+		{
+			if (*p == '/' || *p == '\\')
+				name = p + 1;
+		}
+		return name;
+	}
+}// namespace LoggerUtil
+
+/**
+ * 调用点描述符，每个 LOG_* 宏展开处一个函数内静态对象（常量初始化，无构造开销与线程安全检查）
+ * 首次输出时由库分配从 1 开始的稠密 ID，之后热路径只传递一个指针
+ */
+struct LogSite
+{
+	constexpr LogSite(const char* file, int line, const char* function, LogLevel level)
+		: file(file), line(line), function(function), level(level) {}
+
+	LogSite(const LogSite&) = delete;
+	LogSite& operator=(const LogSite&) = delete;
+
+	const char* file;    // 文件名（编译期截取的 basename）
+	int line;            // 行号
+	const char* function;// 函数名
+	LogLevel level;      // 日志级别
+
+	mutable std::atomic<std::uint32_t> id{0};// 调用点 ID，0 表示尚未注册
+};
+
 
 class LOGGER_API Logger// PIMPL模式，但没有对象指针，因为对外接口都是静态的
 {
+	friend class LogPrivate;
+
 public:
 	/**
 	 * 手动修改读取配置文件的路径
@@ -115,6 +365,139 @@ public:
 	 */
 	static void critical(const char* fileName, int fileLine, const char* function, const std::initializer_list<std::any>& msgList);
 
+	/**
+	 * 输出带行号的日志文本（变参模板版本，LOG_* 宏默认走此接口）
+	 * 每个参数按静态类型直接追加到线程局部缓冲，不做 std::any 装箱，同步模式下稳态零堆分配
+	 * 开启异步延迟格式化（async_deferred_format）时，参数原始值写入定长记录，格式化推迟到后台线程
+	 * 上面的 std::initializer_list<std::any> 接口保留用于 ABI 兼容
+	 * @param level 日志级别
+	 * @param fileName 日志输出位置文件名，应传入宏__FILE__
+	 * @param fileLine 日志输出位置行号，应传入宏__LINE__
+	 * @param function 日志输出所在函数，应传入宏__FUNCTION__
+	 * @param args 日志内容，依次拼接
+	 */
+	template<typename... Args>
+	static void log(LogLevel level, const char* fileName, int fileLine, const char* function, const Args&... args)
+	{
+		if (!shouldLog(level))
+			return;
+		if constexpr (LoggerUtil::IsRecordArgs<Args...>)
+		{
+			if (m_deferredFormat.load(std::memory_order_relaxed))
+			{
+				LoggerUtil::LogRecordWriter record;
+				if ((record.append(args) && ...))// 超出定长容量（如超长字符串）时退回即时格式化
+				{
+					logRecord(level, fileName, fileLine, function, record.data(), record.size());
+					return;
+				}
+			}
+		}
+		LoggerUtil::ScratchBuffer buffer;
+		[[maybe_unused]] const int floatPrecision = m_floatPrecision.load(std::memory_order_relaxed);// 无参数时未使用
+		(LoggerUtil::appendArg(buffer.str(), args, floatPrecision), ...);
+		logText(level, fileName, fileLine, function, buffer.view(), sizeof...(Args));
+	}
+
+	/**
+	 * 同上，参数以 std::forward_as_tuple 打包传入
+	 * 供 LOG_* 宏使用：打包后无参调用 LOG_INFO() 也不会产生多余的逗号
+	 */
+	template<typename... Args>
+	static void log(LogLevel level, const char* fileName, int fileLine, const char* function, const std::tuple<Args...>& args)
+	{
+		std::apply([&](const auto&... unpacked) { log(level, fileName, fileLine, function, unpacked...); }, args);
+	}
+
+	/**
+	 * 输出调用点日志（LOG_* 宏使用），与上面的版本相同，但位置信息由静态调用点描述符一次性提供
+	 * @param site 调用点描述符，须为静态存储期对象
+	 * @param args 日志内容，依次拼接
+	 */
+	template<typename... Args>
+	static void log(const LogSite& site, const Args&... args)
+	{
+		if (!shouldLog(site.level))
+			return;
+		if constexpr (LoggerUtil::IsRecordArgs<Args...>)
+		{
+			if (m_deferredFormat.load(std::memory_order_relaxed))
+			{
+				LoggerUtil::LogRecordWriter record;
+				if ((record.append(args) && ...))
+				{
+					logRecord(site, record.data(), record.size());
+					return;
+				}
+			}
+		}
+		LoggerUtil::ScratchBuffer buffer;
+		[[maybe_unused]] const int floatPrecision = m_floatPrecision.load(std::memory_order_relaxed);// 无参数时未使用
+		(LoggerUtil::appendArg(buffer.str(), args, floatPrecision), ...);
+		logText(site, buffer.view(), sizeof...(Args));
+	}
+
+	/**
+	 * 同上，参数以 std::forward_as_tuple 打包传入
+	 */
+	template<typename... Args>
+	static void log(const LogSite& site, const std::tuple<Args...>& args)
+	{
+		std::apply([&](const auto&... unpacked) { log(site, unpacked...); }, args);
+	}
+
+	/**
+	 * 输出已拼接好的日志文本，供 log 模板调用
+	 * @param level 日志级别
+	 * @param fileName 日志输出位置文件名
+	 * @param fileLine 日志输出位置行号
+	 * @param function 日志输出所在函数
+	 * @param msg 日志文本（调用期间有效即可）
+	 * @param msgCount 原始参数个数，用于区分“内容为空”与“类型转换失败”
+	 */
+	static void logText(LogLevel level, const char* fileName, int fileLine, const char* function,
+						std::string_view msg, std::size_t msgCount);
+
+	/**
+	 * 投递一条延迟格式化记录（见 logrecord.hpp），供 log 模板调用
+	 * @param level 日志级别
+	 * @param fileName 日志输出位置文件名
+	 * @param fileLine 日志输出位置行号
+	 * @param function 日志输出所在函数
+	 * @param record 记录首地址（库内部会写入 flags 字段）
+	 * @param size 记录字节数
+	 */
+	static void logRecord(LogLevel level, const char* fileName, int fileLine, const char* function,
+						  char* record, std::size_t size);
+
+
+	/**
+	 * 输出已拼接好的调用点日志文本，供 log 模板调用；首次调用时为调用点分配 ID
+	 * @param site 调用点描述符
+	 * @param msg 日志文本（调用期间有效即可）
+	 * @param msgCount 原始参数个数
+	 */
+	static void logText(const LogSite& site, std::string_view msg, std::size_t msgCount);
+
+	/**
+	 * 投递一条调用点延迟格式化记录，供 log 模板调用；首次调用时为调用点分配 ID
+	 * @param site 调用点描述符
+	 * @param record 记录首地址（库内部会写入 flags 字段）
+	 * @param size 记录字节数
+	 */
+	static void logRecord(const LogSite& site, char* record, std::size_t size);
+
+	/**
+	 * 已注册（至少输出过一次）的调用点数量，ID 范围为 [1, logSiteCount()]
+	 */
+	static std::uint32_t logSiteCount();
+
+	/**
+	 * 按 ID 查询调用点
+	 * @param id 调用点 ID
+	 * @return 调用点描述符，ID 无效时返回 nullptr
+	 */
+	static const LogSite* getLogSite(std::uint32_t id);
 
 	/**
 	 * 设置日志回调函数，每当日志输出时，调用回调函数
@@ -124,6 +507,70 @@ public:
 	 */
 	static std::string addCallBack(const std::function<void(const LogMsg& logMsg)>& logCallBack, LogLevel level = LogLevel::Trace);
 
+	/**
+	 * 设置日志回调函数，并指定投递方式
+	 * 异步投递时慢回调不会阻塞打日志的线程，同一回调按日志顺序依次调用
+	 * @param logCallBack 日志回调函数
+	 * @param level 日志级别
+	 * @param options 投递方式、队列容量与溢出策略
+	 * @return sinkId 日志回调id
+	 */
+	static std::string addCallBack(const std::function<void(const LogMsg& logMsg)>& logCallBack, LogLevel level,
+								   const CallbackOptions& options);
+
+	/**
+	 * 设置零拷贝视图形式的日志回调函数：字段均为 string_view / 数值，调用回调时不拷贝字符串
+	 * @param logCallBack 日志回调函数，参数仅在回调执行期间有效
+	 * @param level 日志级别
+	 * @param options 投递方式、队列容量与溢出策略
+	 * @return sinkId 日志回调id
+	 */
+	static std::string addCallBack(const std::function<void(const LogMsgView& logMsg)>& logCallBack, LogLevel level = LogLevel::Trace,
+								   const CallbackOptions& options = {});
+
+	/**
+	 * 设置批量日志回调函数，适合把日志转发到界面表格等不宜逐条处理的场景
+	 * 日志由后台线程攒批：满 maxBatch 条或一批中首条日志等待超过 maxDelay 时投递一次；
+	 * 整批文本位于同一块复用的内存中，msgFormatted() 已在后台线程格式化好
+	 * 队列容量为 max(maxBatch * 8, 1024)，满时丢弃最旧的日志（计入 callBackDropCount）
+	 * @param logCallBack 批量回调函数，参数仅在回调执行期间有效
+	 * @param level 日志级别
+	 * @param maxBatch 每批最多条数
+	 * @param maxDelay 一批中首条日志最长等待时间
+	 * @return sinkId 日志回调id，通过 removeCallBack 移除
+	 */
+	static std::string addBatchCallBack(const std::function<void(const LogMsgBatch& batch)>& logCallBack,
+										LogLevel level = LogLevel::Trace, std::size_t maxBatch = 256,
+										std::chrono::milliseconds maxDelay = std::chrono::milliseconds(50));
+
+	/**
+	 * 查询异步回调因队列满丢弃的日志条数
+	 * @param sinkId 日志回调id
+	 * @return 丢弃条数，同步回调或 id 不存在时为 0
+	 */
+	static std::uint64_t callBackDropCount(const std::string& sinkId);
+
+	/**
+	 * 查询当前配置的异步日志队列统计（深度、覆盖与丢弃计数），用于观察 async_overflow_policy 的效果
+	 */
+	static AsyncStats asyncStats();
+
+	/**
+	 * 查询当前配置中各异步 sink 的队列与写入耗时统计，未配置异步 sink 时为空
+	 */
+	static std::vector<AsyncSinkStats> asyncSinkStats();
+
+	/**
+	 * 查询配置文件自动重新加载的统计（计数自进程启动起累计）
+	 */
+	static ConfigReloadStats configReloadStats();
+
+	/**
+	 * 查询日志统计：按级别的条数、各 sink 的写入 / 字节 / 滚动 / 刷新计数、异步队列深度与高水位
+	 * 只读取原子计数，不加日志系统的锁，可在任意线程（包括日志回调中）频繁调用
+	 */
+	static LoggerStats getStats();
+
 	/**
 	 * 移除日志回调函数
 	 * @param sinkId 回调日志id
@@ -135,17 +582,48 @@ public:
 	 * 应在 main() 结束前调用，确保所有日志被写出
 	 */
 	static void shutdown();
+
+	/**
+	 * 判断指定级别的日志当前是否会被输出（logger 级过滤）
+	 * 内联实现，仅一次 relaxed 原子读 + 一次比较，日志宏在求值参数之前先调用它
+	 * @param level 日志级别
+	 * @return true 表示该级别未被过滤
+	 */
+	static bool shouldLog(LogLevel level)
+	{
+		return static_cast<int>(level) >= m_minLevel.load(std::memory_order_relaxed);
+	}
+
+private:
+	// logger 级过滤级别的镜像（数值与 spdlog::level 一致，6 表示 off），由 LogPrivate 在加载配置时同步
+	// 初始为 Trace：日志系统尚未初始化时放行，由首次调用触发初始化
+	static std::atomic<int> m_minLevel;
+
+	// 是否启用异步延迟格式化，由 LogPrivate 在加载配置时同步
+	static std::atomic<bool> m_deferredFormat;
+
+	// 浮点数输出的小数位数（配置项 float_precision），-1 为最短往返表示，由 LogPrivate 在加载配置时同步
+	static std::atomic<int> m_floatPrecision;
 };
 
 // 通过宏定义方式调用日志输出：
 #define GET_LINE __FILE__, __LINE__, __FUNCTION__// 宏，用来代替位置、行号、函数信息这三个宏
 
+// 日志宏先做级别判断，被过滤时不会求值参数，也不进入动态库；未过滤时走零装箱的 Logger::log 模板
+// 每个展开处定义一个静态调用点描述符，文件名在编译期截取为 basename
+#define LOG_IMPL_(level, ...)                                                                                 \
+	do {                                                                                                      \
+		static LogSite logSite_{LoggerUtil::fileBasename(__FILE__), __LINE__, __FUNCTION__, level};           \
+		if (Logger::shouldLog(level))                                                                         \
+			Logger::log(logSite_, std::forward_as_tuple(__VA_ARGS__));                                        \
+	} while (0)
+
 #define LOG_SET_CONFIG_PATH(...) Logger::setConfigPath(__VA_ARGS__)
-#define LOG_TRACE(...) Logger::trace(GET_LINE, {__VA_ARGS__})   // 日志宏，[trace级别]
-#define LOG_DEBUG(...) Logger::debug(GET_LINE, {__VA_ARGS__})   // 同上 [debug级别]
-#define LOG_INFO(...) Logger::info(GET_LINE, {__VA_ARGS__})     // 同上 [info级别]
-#define LOG_WARN(...) Logger::warn(GET_LINE, {__VA_ARGS__})     // 同上 [warn级别]
-#define LOG_ERROR(...) Logger::error(GET_LINE, {__VA_ARGS__})   // 同上 [error级别]
-#define LOG_CRITI(...) Logger::critical(GET_LINE, {__VA_ARGS__})// 同上 [critical级别]
+#define LOG_TRACE(...) LOG_IMPL_(LogLevel::Trace, __VA_ARGS__)   // 日志宏，[trace级别]
+#define LOG_DEBUG(...) LOG_IMPL_(LogLevel::Debug, __VA_ARGS__)   // 同上 [debug级别]
+#define LOG_INFO(...) LOG_IMPL_(LogLevel::Info, __VA_ARGS__)     // 同上 [info级别]
+#define LOG_WARN(...) LOG_IMPL_(LogLevel::Warn, __VA_ARGS__)     // 同上 [warn级别]
+#define LOG_ERROR(...) LOG_IMPL_(LogLevel::Error, __VA_ARGS__)   // 同上 [error级别]
+#define LOG_CRITI(...) LOG_IMPL_(LogLevel::Critical, __VA_ARGS__)// 同上 [critical级别]
 
 #endif//LOGGER_H
@@ -0,0 +1,338 @@
+/*************************************************
+  * 描述：延迟格式化日志记录（定长、带类型标签的参数快照）
+  *
+  * 异步延迟格式化模式下，调用线程只把参数的原始值按类型标签写入定长栈缓冲，
+  * 整条记录作为 spdlog 的 payload 进入异步队列，数值转换、宽字符转码与拼接
+  * 全部在线程池 worker 上由 LogRecordReader 完成
+  *
+  * 记录布局（小端、不对齐，统一用 memcpy 读写）：
+  *   [magic:4][flags:2][argCount:2] 之后每个参数 [tag:1][值]
+  *   Str/WStr 的值为 [长度:4][字节]，WStr 的长度单位为 wchar_t
+  *
+  * File：logrecord.hpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#ifndef LOGGER_LOGRECORD_HPP
+#define LOGGER_LOGRECORD_HPP
+
+#include "anytostring.hpp"
+#include <cstdint>
+#include <cstring>
+#include <cwchar>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace LoggerUtil
+{
+    enum class LogArgTag : std::uint8_t
+    {
+        Bool = 1,
+        Char = 2,
+        Int = 3,  // 有符号整数，统一存为 int64
+        UInt = 4, // 无符号整数，统一存为 uint64
+        Float = 5,
+        Double = 6,
+        Str = 7,
+        WStr = 8,
+        WChar = 9,// 单个宽字符，按 wchar_t 原样存放，输出时转为 UTF-8
+    };
+
+    /// 某个参数类型能否写入延迟格式化记录（其余类型退回调用线程上的即时格式化）
+    /// 整数统一存为 64 位，更宽的整数（gnu++17 下的 __int128）不进入记录
+    template<typename T>
+    struct IsRecordArg
+    {
+        using U = std::decay_t<T>;
+        static constexpr bool value =
+                (std::is_arithmetic_v<U> && (!std::is_integral_v<U> || sizeof(U) <= sizeof(std::int64_t))) ||
+                std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view> ||
+                std::is_same_v<U, const char*> || std::is_same_v<U, char*> ||
+                std::is_same_v<U, std::wstring> || std::is_same_v<U, std::wstring_view> ||
+                std::is_same_v<U, const wchar_t*> || std::is_same_v<U, wchar_t*>;
+    };
+
+    template<typename... Args>
+    inline constexpr bool IsRecordArgs = (IsRecordArg<Args>::value && ...);
+
+    /// 调用线程一侧：把参数原始值写入定长栈缓冲，超出容量时返回 false
+    class LogRecordWriter
+    {
+    public:
+        static constexpr std::uint32_t kMagic = 0x3152431F;// "\x1F" "CR1"，正常文本不会以不可见字符开头
+        static constexpr std::size_t kHeaderSize = 8;
+        static constexpr std::size_t kCapacity = 512;
+
+        // flags 位定义，由库内部在入队前填写
+        static constexpr std::uint16_t kFlagShowLine = 0x1;
+
+        LogRecordWriter()
+        {
+            std::memcpy(m_data, &kMagic, sizeof(kMagic));
+            std::memset(m_data + 4, 0, 4);
+        }
+
+        LogRecordWriter(const LogRecordWriter&) = delete;
+        LogRecordWriter& operator=(const LogRecordWriter&) = delete;
+
+        template<typename T>
+        bool append(const T& value)
+        {
+            using U = std::decay_t<T>;
+            if constexpr (std::is_same_v<U, bool>)
+                return put(LogArgTag::Bool, &value, 1);
+            else if constexpr (std::is_same_v<U, char>)
+                return put(LogArgTag::Char, &value, 1);
+            else if constexpr (std::is_same_v<U, wchar_t>)
+                return put(LogArgTag::WChar, &value, sizeof(value));
+            else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>)
+            {
+                const std::int64_t v = value;
+                return put(LogArgTag::Int, &v, sizeof(v));
+            }
+            else if constexpr (std::is_integral_v<U>)
+            {
+                const std::uint64_t v = value;
+                return put(LogArgTag::UInt, &v, sizeof(v));
+            }
+            else if constexpr (std::is_same_v<U, float>)
+                return put(LogArgTag::Float, &value, sizeof(value));
+            else if constexpr (std::is_floating_point_v<U>)
+            {
+                const double v = static_cast<double>(value);
+                return put(LogArgTag::Double, &v, sizeof(v));
+            }
+            else if constexpr (std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view>)
+                return putString(LogArgTag::Str, value.data(), value.size());
+            else if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*>)
+            {
+                const char* const str = value;// 字符数组（字面量）先退化为指针再判空
+                return putString(LogArgTag::Str, str, str ? std::strlen(str) : 0);
+            }
+            else if constexpr (std::is_same_v<U, std::wstring> || std::is_same_v<U, std::wstring_view>)
+                return putString(LogArgTag::WStr, value.data(), value.size());
+            else
+            {
+                const wchar_t* const str = value;
+                return putString(LogArgTag::WStr, str, str ? std::wcslen(str) : 0);
+            }
+        }
+
+        char* data() { return m_data; }
+
+        std::size_t size() const { return m_size; }
+
+    private:
+        bool put(LogArgTag tag, const void* value, std::size_t len)
+        {
+            if (m_size + 1 + len > kCapacity)
+                return false;
+            m_data[m_size] = static_cast<char>(tag);
+            std::memcpy(m_data + m_size + 1, value, len);
+            m_size += 1 + len;
+            countArg();
+            return true;
+        }
+
+        template<typename CharT>
+        bool putString(LogArgTag tag, const CharT* str, std::size_t len)
+        {
+            const std::size_t bytes = len * sizeof(CharT);
+            if (m_size + 1 + 4 + bytes > kCapacity)
+                return false;
+            const auto len32 = static_cast<std::uint32_t>(len);
+            m_data[m_size] = static_cast<char>(tag);
+            std::memcpy(m_data + m_size + 1, &len32, 4);
+            if (bytes > 0)
+                std::memcpy(m_data + m_size + 5, str, bytes);
+            m_size += 5 + bytes;
+            countArg();
+            return true;
+        }
+
+        void countArg()
+        {
+            std::uint16_t count;
+            std::memcpy(&count, m_data + 6, 2);
+            ++count;
+            std::memcpy(m_data + 6, &count, 2);
+        }
+
+        char m_data[kCapacity];
+        std::size_t m_size = kHeaderSize;
+    };
+
+    /// worker 一侧：识别并解码记录，把参数文本追加到 out
+    class LogRecordReader
+    {
+    public:
+        explicit LogRecordReader(std::string_view record)
+            : m_record(record) {}
+
+        /// payload 是否为延迟格式化记录（普通文本直接透传）
+        static bool isRecord(std::string_view payload)
+        {
+            if (payload.size() < LogRecordWriter::kHeaderSize)
+                return false;
+            std::uint32_t magic;
+            std::memcpy(&magic, payload.data(), 4);
+            return magic == LogRecordWriter::kMagic;
+        }
+
+        static void setFlags(char* record, std::uint16_t flags)
+        {
+            std::memcpy(record + 4, &flags, 2);
+        }
+
+        std::uint16_t flags() const
+        {
+            std::uint16_t flags;
+            std::memcpy(&flags, m_record.data() + 4, 2);
+            return flags;
+        }
+
+        std::uint16_t argCount() const
+        {
+            std::uint16_t count;
+            std::memcpy(&count, m_record.data() + 6, 2);
+            return count;
+        }
+
+        /**
+         * 按写入顺序逐个取出参数原始值交给 visitor，记录损坏时返回 false
+         * visitor 依次收到 bool / char / wchar_t / int64_t / uint64_t / float / double / string_view / wstring_view
+         */
+        template<typename Visitor>
+        bool forEachArg(Visitor&& visitor) const
+        {
+            std::size_t pos = LogRecordWriter::kHeaderSize;
+            std::wstring wide;// 记录内不保证 wchar_t 对齐，先拷出再交给 visitor
+            for (std::uint16_t i = 0; i < argCount(); ++i)
+            {
+                if (pos >= m_record.size())
+                    return false;
+                const auto tag = static_cast<LogArgTag>(m_record[pos++]);
+                switch (tag)
+                {
+                    case LogArgTag::Bool:
+                    {
+                        bool v;
+                        if (!read(pos, &v, 1)) return false;
+                        visitor(v);
+                        break;
+                    }
+                    case LogArgTag::Char:
+                    {
+                        char v;
+                        if (!read(pos, &v, 1)) return false;
+                        visitor(v);
+                        break;
+                    }
+                    case LogArgTag::WChar:
+                    {
+                        wchar_t v;
+                        if (!read(pos, &v, sizeof(v))) return false;
+                        visitor(v);
+                        break;
+                    }
+                    case LogArgTag::Int:
+                    {
+                        std::int64_t v;
+                        if (!read(pos, &v, sizeof(v))) return false;
+                        visitor(v);
+                        break;
+                    }
+                    case LogArgTag::UInt:
+                    {
+                        std::uint64_t v;
+                        if (!read(pos, &v, sizeof(v))) return false;
+                        visitor(v);
+                        break;
+                    }
+                    case LogArgTag::Float:
+                    {
+                        float v;
+                        if (!read(pos, &v, sizeof(v))) return false;
+                        visitor(v);
+                        break;
+                    }
+                    case LogArgTag::Double:
+                    {
+                        double v;
+                        if (!read(pos, &v, sizeof(v))) return false;
+                        visitor(v);
+                        break;
+                    }
+                    case LogArgTag::Str:
+                    {
+                        std::uint32_t len;
+                        if (!read(pos, &len, 4) || pos + len > m_record.size()) return false;
+                        visitor(m_record.substr(pos, len));
+                        pos += len;
+                        break;
+                    }
+                    case LogArgTag::WStr:
+                    {
+                        std::uint32_t len;
+                        if (!read(pos, &len, 4) || pos + len * sizeof(wchar_t) > m_record.size()) return false;
+                        wide.resize(len);
+                        std::memcpy(wide.data(), m_record.data() + pos, len * sizeof(wchar_t));
+                        pos += len * sizeof(wchar_t);
+                        visitor(std::wstring_view(wide));
+                        break;
+                    }
+                    default:
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        /// 逐个参数格式化并追加，格式与即时格式化路径（appendArg）完全一致；记录损坏时返回 false
+        template<typename Out>
+        bool appendText(Out& out, int floatPrecision = kShortestFloat) const
+        {
+            return forEachArg([&out, floatPrecision](auto value) { appendValue(out, value, floatPrecision); });
+        }
+
+        /// 追加单个参数值的文本（forEachArg 取出的类型之一）
+        template<typename Out, typename T>
+        static void appendValue(Out& out, T value, int floatPrecision = kShortestFloat)
+        {
+            if constexpr (std::is_same_v<T, std::string_view>)
+                append(out, value);
+            else if constexpr (std::is_same_v<T, bool>)
+                append(out, value ? std::string_view("true") : std::string_view("false"));
+            else if constexpr (std::is_same_v<T, char>)
+                append(out, std::string_view(&value, 1));
+            else
+            {
+                ScratchBuffer buffer;
+                appendArg(buffer.str(), value, floatPrecision);
+                append(out, buffer.view());
+            }
+        }
+
+    private:
+        bool read(std::size_t& pos, void* value, std::size_t len) const
+        {
+            if (pos + len > m_record.size())
+                return false;
+            std::memcpy(value, m_record.data() + pos, len);
+            pos += len;
+            return true;
+        }
+
+        template<typename Out>
+        static void append(Out& out, std::string_view text)
+        {
+            out.append(text.data(), text.data() + text.size());
+        }
+
+        std::string_view m_record;
+    };
+}
+
+#endif//LOGGER_LOGRECORD_HPP
@@ -0,0 +1,214 @@
+/*************************************************
+  * 描述：宽字符串（wchar_t）到 UTF-8 的转码
+  *
+  * wchar_t 为 4 字节（Linux/macOS）时按 UTF-32 处理，为 2 字节（Windows）时按 UTF-16 处理：
+  *  - 不依赖 locale / std::codecvt / WideCharToMultiByte，按 wstring_view 的长度转换（内嵌的 0 原样保留）
+  *  - ASCII 快速路径：AVX2 每步检查 32 个码元，SSE2 每步 16 个，其他平台逐个码元
+  *  - 非法码元（UTF-32 中的代理区或超出 U+10FFFF，UTF-16 中不成对的代理）输出 U+FFFD
+  *
+  * File：wideutf8.hpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#ifndef LOGGER_WIDEUTF8_HPP
+#define LOGGER_WIDEUTF8_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define LOGGER_UTF8_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LOGGER_UTF8_SSE2 1
+#endif
+
+namespace LoggerUtil
+{
+    namespace Utf8Detail
+    {
+        constexpr char32_t kReplacement = 0xFFFD;
+
+        /// 单个码点编码为 UTF-8，返回写入的字节数（调用方保证 cp 合法）
+        inline std::size_t encode(char32_t cp, char* dst)
+        {
+            if (cp < 0x80)
+            {
+                dst[0] = static_cast<char>(cp);
+                return 1;
+            }
+            if (cp < 0x800)
+            {
+                dst[0] = static_cast<char>(0xC0 | (cp >> 6));
+                dst[1] = static_cast<char>(0x80 | (cp & 0x3F));
+                return 2;
+            }
+            if (cp < 0x10000)
+            {
+                dst[0] = static_cast<char>(0xE0 | (cp >> 12));
+                dst[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                dst[2] = static_cast<char>(0x80 | (cp & 0x3F));
+                return 3;
+            }
+            dst[0] = static_cast<char>(0xF0 | (cp >> 18));
+            dst[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            dst[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            dst[3] = static_cast<char>(0x80 | (cp & 0x3F));
+            return 4;
+        }
+
+        /**
+         * 以 SIMD 拷贝开头的纯 ASCII 段，遇到非 ASCII 码元所在的块即停止
+         * @return 已处理的码元个数（dst 中写入同样多的字节）
+         */
+        template<typename Unit>
+        inline std::size_t copyAscii(const Unit* src, std::size_t n, char* dst)
+        {
+            std::size_t i = 0;
+#if defined(LOGGER_UTF8_AVX2)
+            if constexpr (sizeof(Unit) == 4)
+            {
+                const __m256i high = _mm256_set1_epi32(static_cast<int>(0xFFFFFF80u));
+                for (; i + 32 <= n; i += 32)
+                {
+                    const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+                    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 8));
+                    const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 16));
+                    const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 24));
+                    const __m256i any = _mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d));
+                    if (!_mm256_testz_si256(any, high))
+                        break;
+                    // 32 位 -> 16 位在 128 位通道内交错，permute 恢复顺序后再压到 8 位
+                    const __m256i ab = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+                    const __m256i cd = _mm256_permute4x64_epi64(_mm256_packs_epi32(c, d), 0xD8);
+                    const __m256i bytes = _mm256_permute4x64_epi64(_mm256_packus_epi16(ab, cd), 0xD8);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), bytes);
+                }
+            }
+            else
+            {
+                const __m256i high = _mm256_set1_epi16(static_cast<short>(0xFF80));
+                for (; i + 32 <= n; i += 32)
+                {
+                    const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+                    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 16));
+                    if (!_mm256_testz_si256(_mm256_or_si256(a, b), high))
+                        break;
+                    const __m256i bytes = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), bytes);
+                }
+            }
+#endif
+#if defined(LOGGER_UTF8_SSE2)
+            if constexpr (sizeof(Unit) == 4)
+            {
+                const __m128i high = _mm_set1_epi32(static_cast<int>(0xFFFFFF80u));
+                for (; i + 16 <= n; i += 16)
+                {
+                    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 4));
+                    const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+                    const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12));
+                    const __m128i any = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), high);
+                    if (_mm_movemask_epi8(_mm_cmpeq_epi32(any, _mm_setzero_si128())) != 0xFFFF)
+                        break;
+                    const __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), bytes);
+                }
+            }
+            else
+            {
+                const __m128i high = _mm_set1_epi16(static_cast<short>(0xFF80));
+                for (; i + 16 <= n; i += 16)
+                {
+                    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+                    const __m128i any = _mm_and_si128(_mm_or_si128(a, b), high);
+                    if (_mm_movemask_epi8(_mm_cmpeq_epi16(any, _mm_setzero_si128())) != 0xFFFF)
+                        break;
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(a, b));
+                }
+            }
+#endif
+            for (; i < n && static_cast<std::uint32_t>(src[i]) < 0x80; ++i)
+            {
+                dst[i] = static_cast<char>(src[i]);
+            }
+            return i;
+        }
+
+        /// 解码一个码点并前移 i；UTF-16 的代理对合并为一个码点，非法码元返回 U+FFFD
+        template<typename Unit>
+        inline char32_t decode(const Unit* src, std::size_t n, std::size_t& i)
+        {
+            const auto unit = static_cast<std::uint32_t>(src[i++]);
+            if constexpr (sizeof(Unit) == 4)
+            {
+                if (unit > 0x10FFFF || (unit >= 0xD800 && unit <= 0xDFFF))
+                    return kReplacement;
+                return static_cast<char32_t>(unit);
+            }
+            else
+            {
+                const std::uint32_t u = unit & 0xFFFF;
+                if (u < 0xD800 || u > 0xDFFF)
+                    return static_cast<char32_t>(u);
+                if (u <= 0xDBFF && i < n)
+                {
+                    const std::uint32_t low = static_cast<std::uint32_t>(src[i]) & 0xFFFF;
+                    if (low >= 0xDC00 && low <= 0xDFFF)
+                    {
+                        ++i;
+                        return static_cast<char32_t>(0x10000 + ((u - 0xD800) << 10) + (low - 0xDC00));
+                    }
+                }
+                return kReplacement;
+            }
+        }
+    }// namespace Utf8Detail
+
+    /// 把宽字符串转为 UTF-8 追加到 out
+    inline void appendUtf8(std::string& out, std::wstring_view wstr)
+    {
+        if (wstr.empty())
+            return;
+
+        // 先按最坏情况扩容（UTF-32 每码元至多 4 字节，UTF-16 至多 3 字节），写完再截到实际长度
+        constexpr std::size_t kMaxBytesPerUnit = sizeof(wchar_t) == 4 ? 4 : 3;
+        const std::size_t base = out.size();
+        out.resize(base + wstr.size() * kMaxBytesPerUnit);
+        char* const begin = &out[base];
+        char* dst = begin;
+
+        const wchar_t* src = wstr.data();
+        const std::size_t n = wstr.size();
+        std::size_t i = 0;
+        while (i < n)
+        {
+            const std::size_t ascii = Utf8Detail::copyAscii(src + i, n - i, dst);
+            i += ascii;
+            dst += ascii;
+            // 非 ASCII 段逐码点编码，直到重新遇到 ASCII 再回到快速路径
+            while (i < n && static_cast<std::uint32_t>(src[i]) >= 0x80)
+            {
+                dst += Utf8Detail::encode(Utf8Detail::decode(src, n, i), dst);
+            }
+        }
+        out.resize(base + static_cast<std::size_t>(dst - begin));
+    }
+
+    /// 宽字符转 UTF-8（不使用已废弃的 std::codecvt）
+    inline std::string wstringToUtf8(std::wstring_view wstr)
+    {
+        std::string result;
+        appendUtf8(result, wstr);
+        return result;
+    }
+}// namespace LoggerUtil
+
+#endif// LOGGER_WIDEUTF8_HPP
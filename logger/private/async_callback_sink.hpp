@@ -0,0 +1,466 @@
+/*************************************************
+  * 描述：回调sink（同步 / 异步投递 / 批量投递）
+  *
+  * 回调参数为 LogMsgView（字段指向 sink 内部缓冲），旧的 LogMsg 接口在外层按需由视图构造；
+  * pattern 格式化推迟到回调首次读取 msgFormatted() 时，不读取的回调不做格式化
+  *
+  * callback_sink：在打日志的线程（异步 logger 下为线程池 worker）上直接调用回调
+  * queued_sink：只把日志的原始字段拷入回调专属的有界无锁队列（mpmc_queue.hpp），由独立的分发线程处理，
+  * 慢回调不会拖住打日志的线程：
+  *  - 队列满时按策略处理：丢弃最旧 / 丢弃最新 / 阻塞等待，丢弃的条数计入 dropped()
+  *  - 队列槽位中的字符串常驻复用，稳态下入队不分配内存
+  *  - 析构时分发线程先处理完队列中剩余的日志再退出；在回调中移除自身时分发线程自行退出
+  *  - async_callback_sink：逐条调用回调
+  *  - batch_callback_sink：攒满 max_batch 条或首条等待超过 max_delay 后一次性投递一批，
+  *    整批文本位于同一块复用的内存（arena）中，稳态下投递一批不分配内存
+  *
+  * source_loc 中的文件名、函数名按指针保存（均来自 __FILE__ / __FUNCTION__ 等静态字符串）
+  *
+  * 统计（counted_sink）：已投递的条数与消息文本字节数、丢弃条数，由调用回调的线程以 relaxed 原子加更新
+  *
+  * File：async_callback_sink.hpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#ifndef COREXI_COMMON_PC_ASYNC_CALLBACK_SINK_HPP
+#define COREXI_COMMON_PC_ASYNC_CALLBACK_SINK_HPP
+
+#include "mpmc_queue.hpp"
+#include "sink_counters.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <logger/logger.h>
+#include <memory>
+#include <mutex>
+#include <spdlog/pattern_formatter.h>
+#include <spdlog/sinks/base_sink.h>
+#include <spdlog/sinks/sink.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace CustomSink
+{
+	using log_callback_t = std::function<void(const LogMsgView&)>;
+	using batch_callback_t = std::function<void(const LogMsgBatch&)>;
+
+	/// 延迟格式化所需的上下文，在调用回调的栈帧上构造
+	struct lazy_format_context
+	{
+		const spdlog::details::log_msg* msg;
+		const std::unique_ptr<spdlog::formatter>* formatter;
+		spdlog::memory_buf_t* buffer;
+		std::mutex* formatter_mutex;// 格式化器可能被并发替换时非空
+	};
+
+	inline std::string_view format_lazily(const void* context)
+	{
+		const auto& ctx = *static_cast<const lazy_format_context*>(context);
+		ctx.buffer->clear();
+		if (ctx.formatter_mutex)
+		{
+			std::lock_guard<std::mutex> lock(*ctx.formatter_mutex);
+			(*ctx.formatter)->format(*ctx.msg, *ctx.buffer);
+		}
+		else
+		{
+			(*ctx.formatter)->format(*ctx.msg, *ctx.buffer);
+		}
+		return {ctx.buffer->data(), ctx.buffer->size()};
+	}
+
+	/// 由 spdlog 日志消息构造回调参数视图（不拷贝字符串），msgFormatted 在回调首次访问时才格式化
+	inline LogMsgView make_log_msg_view(const spdlog::details::log_msg& msg, const lazy_format_context& context)
+	{
+		LogMsgView view;
+		if (msg.source.filename)
+			view.fileName = msg.source.filename;
+		view.codeLine = msg.source.line;
+		if (msg.source.funcname)
+			view.funcName = msg.source.funcname;
+		view.threadId = msg.thread_id;
+		view.level = static_cast<LogLevel>(msg.level);
+		view.msg = std::string_view(msg.payload.data(), msg.payload.size());
+		view.time = msg.time;
+		view.loggerName = std::string_view(msg.logger_name.data(), msg.logger_name.size());
+		view.bindFormatter(&format_lazily, &context);
+		return view;
+	}
+
+	// 不使用spdlog原生call_back_sink：只能取得日志原始内容，无法获取格式化内容
+	class callback_sink : public spdlog::sinks::base_sink<std::mutex>, public counted_sink
+	{
+	public:
+		explicit callback_sink(log_callback_t cb)
+			: callback_(std::move(cb)) {}
+
+		const sink_counters& counters() const override
+		{
+			return counters_;
+		}
+
+	protected:
+		void sink_it_(const spdlog::details::log_msg& msg) override
+		{
+			if (!callback_)
+				return;
+			// 回调在 base_sink 的锁内执行，格式化器不会被并发替换
+			const lazy_format_context context{&msg, &this->formatter_, &formatted_, nullptr};
+			callback_(make_log_msg_view(msg, context));
+			counters_.on_write(1, msg.payload.size());
+		}
+
+		void flush_() override {}
+
+	private:
+		log_callback_t callback_;
+		sink_counters counters_;
+		spdlog::memory_buf_t formatted_;// 由 base_sink 的互斥锁保护
+	};
+
+	/// 队列中的一条日志（原始字段的拷贝）
+	struct queued_entry
+	{
+		spdlog::log_clock::time_point time;
+		spdlog::source_loc source;
+		spdlog::level::level_enum level = spdlog::level::trace;
+		std::size_t thread_id = 0;
+		std::string logger_name;
+		std::string payload;
+
+		spdlog::details::log_msg to_log_msg() const
+		{
+			spdlog::details::log_msg msg(time, source, logger_name, level, payload);
+			msg.thread_id = thread_id;
+			return msg;
+		}
+	};
+
+	/**
+	 * 队列与分发线程的共享状态，sink 在分发线程内被析构时由线程继续持有
+	 * 派生类实现 run()（分发线程主循环）
+	 */
+	struct queue_state
+	{
+		queue_state(std::size_t queue_size, CallbackOverflow overflow)
+			: queue(queue_size), overflow(overflow) {}
+
+		virtual ~queue_state() = default;
+
+		virtual void run() = 0;
+
+		void wake_worker()
+		{
+			std::lock_guard<std::mutex> lock(wake_mutex);
+			wake.notify_one();
+		}
+
+		/**
+		 * 队列不足 wake_threshold 条时休眠，直到被生产者唤醒、停止或到达 deadline
+		 */
+		void sleep_until(std::chrono::steady_clock::time_point deadline)
+		{
+			std::unique_lock<std::mutex> lock(wake_mutex);
+			sleeping.store(true, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (queue.sizeApprox() < wake_threshold.load(std::memory_order_relaxed) &&
+				!stop.load(std::memory_order_relaxed))
+			{
+				wake.wait_until(lock, deadline);
+			}
+			sleeping.store(false, std::memory_order_relaxed);
+		}
+
+		MpmcQueue<queued_entry> queue;
+		const CallbackOverflow overflow;
+		sink_counters counters;// dropped 为因队列满丢弃的条数
+		std::atomic<bool> stop{false};
+		std::atomic<bool> sleeping{false};
+		std::atomic<std::size_t> wake_threshold{1};// 分发线程休眠时，队列达到该条数才唤醒
+		std::mutex wake_mutex;
+		std::condition_variable wake;
+		std::mutex formatter_mutex;
+		std::unique_ptr<spdlog::formatter> formatter = std::make_unique<spdlog::pattern_formatter>();
+		std::atomic<std::thread::id> worker_id{};// 分发线程启动时自行写入，生产者线程并发读取
+	};
+
+	class queued_sink : public spdlog::sinks::sink, public counted_sink
+	{
+	public:
+		queued_sink(const queued_sink&) = delete;
+		queued_sink& operator=(const queued_sink&) = delete;
+
+		~queued_sink() override
+		{
+			state_->stop.store(true, std::memory_order_seq_cst);
+			state_->wake_worker();
+			if (std::this_thread::get_id() == worker_.get_id())
+			{
+				worker_.detach();// 在回调中移除了自身：当前回调返回后分发线程自行退出
+				return;
+			}
+			worker_.join();
+		}
+
+		void log(const spdlog::details::log_msg& msg) override
+		{
+			queue_state& s = *state_;
+			auto fill = [&msg](queued_entry& e) {
+				e.time = msg.time;
+				e.source = msg.source;
+				e.level = msg.level;
+				e.thread_id = msg.thread_id;
+				e.logger_name.assign(msg.logger_name.data(), msg.logger_name.size());
+				e.payload.assign(msg.payload.data(), msg.payload.size());
+			};
+			if (!s.queue.tryPush(fill))
+			{
+				// 分发线程自己打日志时不能阻塞等待自己
+				CallbackOverflow overflow = s.overflow;
+				if (overflow == CallbackOverflow::Block &&
+					std::this_thread::get_id() == s.worker_id.load(std::memory_order_relaxed))
+					overflow = CallbackOverflow::DropNewest;
+				switch (overflow)
+				{
+					case CallbackOverflow::DropNewest:
+						s.counters.dropped.fetch_add(1, std::memory_order_relaxed);
+						return;
+					case CallbackOverflow::DropOldest:
+						do
+						{
+							if (s.queue.tryPop([](queued_entry&) {}))
+								s.counters.dropped.fetch_add(1, std::memory_order_relaxed);
+						} while (!s.queue.tryPush(fill));
+						break;
+					case CallbackOverflow::Block:
+						while (!s.queue.tryPush(fill))
+						{
+							if (s.stop.load(std::memory_order_relaxed))
+							{
+								s.counters.dropped.fetch_add(1, std::memory_order_relaxed);
+								return;
+							}
+							s.wake_worker();
+							std::this_thread::yield();
+						}
+						break;
+				}
+			}
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (s.sleeping.load(std::memory_order_relaxed) &&
+				s.queue.sizeApprox() >= s.wake_threshold.load(std::memory_order_relaxed))
+			{
+				s.wake_worker();
+			}
+		}
+
+		// 刷新不等待队列排空：flush_on 可能对每条日志调用
+		void flush() override {}
+
+		void set_pattern(const std::string& pattern) override
+		{
+			set_formatter(std::make_unique<spdlog::pattern_formatter>(pattern));
+		}
+
+		void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override
+		{
+			std::lock_guard<std::mutex> lock(state_->formatter_mutex);
+			state_->formatter = std::move(sink_formatter);
+		}
+
+		/// 因队列满被丢弃的日志条数
+		std::uint64_t dropped() const
+		{
+			return state_->counters.dropped.load(std::memory_order_relaxed);
+		}
+
+		const sink_counters& counters() const override
+		{
+			return state_->counters;
+		}
+
+	protected:
+		explicit queued_sink(std::shared_ptr<queue_state> state)
+			: state_(std::move(state))
+		{
+			worker_ = std::thread([s = state_] {
+				s->worker_id.store(std::this_thread::get_id(), std::memory_order_relaxed);
+				s->run();
+			});
+		}
+
+	private:
+		std::shared_ptr<queue_state> state_;
+		std::thread worker_;
+	};
+
+	class async_callback_sink : public queued_sink
+	{
+	public:
+		async_callback_sink(log_callback_t cb, std::size_t queue_size, CallbackOverflow overflow)
+			: queued_sink(std::make_shared<state>(std::move(cb), queue_size, overflow)) {}
+
+	private:
+		struct state : queue_state
+		{
+			state(log_callback_t cb, std::size_t queue_size, CallbackOverflow overflow)
+				: queue_state(queue_size, overflow), callback(std::move(cb)) {}
+
+			void run() override
+			{
+				spdlog::memory_buf_t formatted;
+				auto deliver = [&](queued_entry& e) {
+					const spdlog::details::log_msg msg = e.to_log_msg();
+					const lazy_format_context context{&msg, &formatter, &formatted, &formatter_mutex};
+					if (callback)
+						callback(make_log_msg_view(msg, context));
+					counters.on_write(1, e.payload.size());
+				};
+
+				for (;;)
+				{
+					if (queue.tryPop(deliver))
+						continue;
+					if (stop.load(std::memory_order_acquire))
+					{
+						// 停止前投递完剩余日志
+						while (queue.tryPop(deliver))
+						{
+						}
+						return;
+					}
+					sleep_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(100));
+				}
+			}
+
+			log_callback_t callback;
+		};
+	};
+
+	class batch_callback_sink : public queued_sink
+	{
+	public:
+		/**
+		 * @param cb 批量回调
+		 * @param max_batch 每批最多条数
+		 * @param max_delay 一批中首条日志最长等待时间
+		 * @param queue_size 队列容量，满时丢弃最旧的日志
+		 */
+		batch_callback_sink(batch_callback_t cb, std::size_t max_batch, std::chrono::milliseconds max_delay,
+							std::size_t queue_size)
+			: queued_sink(std::make_shared<state>(std::move(cb), max_batch, max_delay, queue_size)) {}
+
+	private:
+		struct state : queue_state
+		{
+			state(batch_callback_t cb, std::size_t max_batch, std::chrono::milliseconds max_delay, std::size_t queue_size)
+				: queue_state(queue_size, CallbackOverflow::DropOldest), callback(std::move(cb)),
+				  max_batch(max_batch), max_delay(max_delay) {}
+
+			// 字段在 arena 中的偏移；arena 扩容会使指针失效，整批收齐后再构造视图
+			struct record
+			{
+				spdlog::log_clock::time_point time;
+				spdlog::source_loc source;
+				spdlog::level::level_enum level;
+				std::size_t thread_id;
+				std::size_t logger_name, logger_name_size;
+				std::size_t payload, payload_size;
+				std::size_t formatted, formatted_size;
+			};
+
+			std::size_t append_text(const char* data, std::size_t size)
+			{
+				const std::size_t offset = arena.size();
+				arena.append(data, size);
+				return offset;
+			}
+
+			void append(queued_entry& e)
+			{
+				const spdlog::details::log_msg msg = e.to_log_msg();
+				formatted.clear();
+				{
+					std::lock_guard<std::mutex> lock(formatter_mutex);
+					formatter->format(msg, formatted);
+				}
+				record r{e.time, e.source, e.level, e.thread_id, 0, e.logger_name.size(), 0, e.payload.size(), 0,
+						 formatted.size()};
+				r.logger_name = append_text(e.logger_name.data(), e.logger_name.size());
+				r.payload = append_text(e.payload.data(), e.payload.size());
+				r.formatted = append_text(formatted.data(), formatted.size());
+				records.push_back(r);
+			}
+
+			void deliver()
+			{
+				views.clear();
+				const char* base = arena.data();
+				std::uint64_t bytes = 0;
+				for (const record& r: records)
+				{
+					bytes += r.payload_size;
+					LogMsgView view;
+					if (r.source.filename)
+						view.fileName = r.source.filename;
+					view.codeLine = r.source.line;
+					if (r.source.funcname)
+						view.funcName = r.source.funcname;
+					view.threadId = r.thread_id;
+					view.level = static_cast<LogLevel>(r.level);
+					view.msg = std::string_view(base + r.payload, r.payload_size);
+					view.time = r.time;
+					view.loggerName = std::string_view(base + r.logger_name, r.logger_name_size);
+					view.setFormatted(std::string_view(base + r.formatted, r.formatted_size));
+					views.push_back(view);
+				}
+				if (callback)
+					callback(LogMsgBatch{views.data(), views.size()});
+				counters.on_write(records.size(), bytes);
+				records.clear();
+				arena.clear();// 保留容量，下一批复用
+			}
+
+			void run() override
+			{
+				auto collect = [this](queued_entry& e) { append(e); };
+				for (;;)
+				{
+					// 等待一批的首条日志
+					wake_threshold.store(1, std::memory_order_relaxed);
+					while (!queue.tryPop(collect))
+					{
+						if (stop.load(std::memory_order_acquire))
+							return;
+						sleep_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(100));
+					}
+					// 攒批：满 max_batch 条或到达首条的 deadline 即投递；停止时立即投递
+					const auto deadline = std::chrono::steady_clock::now() + max_delay;
+					while (records.size() < max_batch)
+					{
+						if (queue.tryPop(collect))
+							continue;
+						if (stop.load(std::memory_order_acquire) || std::chrono::steady_clock::now() >= deadline)
+							break;
+						wake_threshold.store(max_batch - records.size(), std::memory_order_relaxed);
+						sleep_until(deadline);
+					}
+					deliver();
+				}
+			}
+
+			batch_callback_t callback;
+			const std::size_t max_batch;
+			const std::chrono::milliseconds max_delay;
+			std::string arena;
+			std::vector<record> records;
+			std::vector<LogMsgView> views;
+			spdlog::memory_buf_t formatted;
+		};
+	};
+}// namespace CustomSink
+
+#endif// COREXI_COMMON_PC_ASYNC_CALLBACK_SINK_HPP
@@ -0,0 +1,217 @@
+/*************************************************
+  * 描述：单个 sink 的异步隔离
+  *
+  * sink 配置 async: true 时，用 async_sink 包装真正的 sink：
+  *  - 日志按原样（保留线程 id、时间、logger 名称）投递到该 sink 专属的 spdlog 线程池队列，或 thread_pools 中定义的具名线程池，
+  *    由线程池 worker 写入，慢 sink（NFS 上的滚动文件、被阻塞的 stdout 管道）不会拖住其他 sink
+  *  - 队列满时按 sink 的 async_overflow_policy 处理（默认沿用 logger 的 async_overflow_policy）
+  *  - flush 不入队：由内部 async_logger 的 flush_on 在 worker 上写完后刷新
+  *  - stall_meter_sink 统计每次写入/刷新的耗时（累计、最大、当前正在进行的写入已耗时），用于发现卡住的 sink
+  *
+  * 线程池由 sink 共同持有，最后一个使用它的 sink 析构时排空队列后退出
+  *
+  * File：async_sink.hpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#ifndef COREXI_COMMON_PC_ASYNC_SINK_HPP
+#define COREXI_COMMON_PC_ASYNC_SINK_HPP
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <spdlog/async.h>
+#include <spdlog/async_logger.h>
+#include <spdlog/pattern_formatter.h>
+#include <spdlog/sinks/sink.h>
+#include <string>
+
+namespace CustomSink
+{
+	/// 转发到内部 sink 并统计写入耗时
+	class stall_meter_sink : public spdlog::sinks::sink
+	{
+	public:
+		explicit stall_meter_sink(std::shared_ptr<spdlog::sinks::sink> inner)
+			: inner_(std::move(inner)) {}
+
+		void log(const spdlog::details::log_msg& msg) override
+		{
+			const auto start = begin_();
+			inner_->log(msg);
+			end_(start);
+			written_.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void flush() override
+		{
+			const auto start = begin_();
+			inner_->flush();
+			end_(start);
+		}
+
+		void set_pattern(const std::string& pattern) override
+		{
+			inner_->set_pattern(pattern);
+		}
+
+		void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override
+		{
+			inner_->set_formatter(std::move(sink_formatter));
+		}
+
+		std::uint64_t written() const
+		{
+			return written_.load(std::memory_order_relaxed);
+		}
+
+		std::chrono::nanoseconds stall_total() const
+		{
+			return std::chrono::nanoseconds(stall_total_.load(std::memory_order_relaxed));
+		}
+
+		std::chrono::nanoseconds stall_max() const
+		{
+			return std::chrono::nanoseconds(stall_max_.load(std::memory_order_relaxed));
+		}
+
+		/// 正在进行的写入已耗时，未在写入时为 0
+		std::chrono::nanoseconds current_stall() const
+		{
+			const auto since = busy_since_.load(std::memory_order_relaxed);
+			if (since == 0)
+				return std::chrono::nanoseconds(0);
+			const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+			return std::chrono::nanoseconds(now > since ? now - since : 0);
+		}
+
+	private:
+		using rep = std::chrono::steady_clock::rep;
+
+		rep begin_()
+		{
+			const rep start = std::chrono::steady_clock::now().time_since_epoch().count();
+			busy_since_.store(start, std::memory_order_relaxed);
+			return start;
+		}
+
+		void end_(rep start)
+		{
+			const rep elapsed = std::chrono::steady_clock::now().time_since_epoch().count() - start;
+			busy_since_.store(0, std::memory_order_relaxed);
+			stall_total_.fetch_add(elapsed, std::memory_order_relaxed);
+			rep max = stall_max_.load(std::memory_order_relaxed);
+			while (elapsed > max && !stall_max_.compare_exchange_weak(max, elapsed, std::memory_order_relaxed))
+			{
+			}
+		}
+
+		std::shared_ptr<spdlog::sinks::sink> inner_;
+		std::atomic<std::uint64_t> written_{0};
+		std::atomic<rep> stall_total_{0};
+		std::atomic<rep> stall_max_{0};
+		std::atomic<rep> busy_since_{0};// 正在写入时为开始时刻（steady_clock 计数），多 worker 共用同一 sink 时为最近一次开始的写入
+	};
+
+	class async_sink : public spdlog::sinks::sink
+	{
+	public:
+		/**
+		 * @param inner 真正的 sink，其级别同时用作入队前的过滤级别
+		 * @param label 统计中显示的名称
+		 * @param pool 使用的线程池（专属或具名）
+		 * @param pool_name 具名线程池名称，专属队列为空
+		 * @param queue_capacity 线程池队列容量
+		 * @param overflow_policy 队列满时的处理
+		 * @param flush_level 写入不低于该级别的日志后刷新
+		 */
+		async_sink(std::shared_ptr<spdlog::sinks::sink> inner, std::string label,
+				   std::shared_ptr<spdlog::details::thread_pool> pool, std::string pool_name, std::size_t queue_capacity,
+				   spdlog::async_overflow_policy overflow_policy, spdlog::level::level_enum flush_level)
+			: meter_(std::make_shared<stall_meter_sink>(inner)),
+			  backend_(std::make_shared<spdlog::async_logger>(label, meter_, pool, overflow_policy)),
+			  pool_(std::move(pool)),
+			  label_(std::move(label)),
+			  pool_name_(std::move(pool_name)),
+			  queue_capacity_(queue_capacity),
+			  overflow_policy_(overflow_policy)
+		{
+			set_level(inner->level());
+			backend_->set_level(spdlog::level::trace);
+			backend_->flush_on(flush_level);
+		}
+
+		void log(const spdlog::details::log_msg& msg) override
+		{
+			pool_->post_log(std::shared_ptr<spdlog::async_logger>(backend_), msg, overflow_policy_);
+			enqueued_.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// 刷新由 worker 按 flush_on 完成，不为每次 flush 入队
+		void flush() override {}
+
+		void set_pattern(const std::string& pattern) override
+		{
+			meter_->set_pattern(pattern);
+		}
+
+		void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override
+		{
+			meter_->set_formatter(std::move(sink_formatter));
+		}
+
+		const std::string& label() const
+		{
+			return label_;
+		}
+
+		const std::string& pool_name() const
+		{
+			return pool_name_;
+		}
+
+		std::size_t queue_capacity() const
+		{
+			return queue_capacity_;
+		}
+
+		std::size_t queue_depth() const
+		{
+			return pool_->queue_size();
+		}
+
+		std::uint64_t overrun_count() const
+		{
+			return pool_->overrun_counter();
+		}
+
+		std::uint64_t discard_count() const
+		{
+			return pool_->discard_counter();
+		}
+
+		/// 提交给队列的条数（含因队列满被丢弃的）
+		std::uint64_t enqueued() const
+		{
+			return enqueued_.load(std::memory_order_relaxed);
+		}
+
+		const stall_meter_sink& meter() const
+		{
+			return *meter_;
+		}
+
+	private:
+		std::shared_ptr<stall_meter_sink> meter_;
+		std::shared_ptr<spdlog::async_logger> backend_;
+		std::shared_ptr<spdlog::details::thread_pool> pool_;
+		const std::string label_;
+		const std::string pool_name_;
+		const std::size_t queue_capacity_;
+		const spdlog::async_overflow_policy overflow_policy_;
+		std::atomic<std::uint64_t> enqueued_{0};
+	};
+}// namespace CustomSink
+
+#endif// COREXI_COMMON_PC_ASYNC_SINK_HPP
@@ -0,0 +1,79 @@
+/*************************************************
+  * 描述：批量写入的文件 sink
+  *
+  * batch_sink：可一次接收一批日志的 sink 接口。异步 worker 攒够一批后调用 log_batch()，
+  * sink 只加一次锁，把整批格式化进同一块复用的缓冲后一次写出；未实现该接口的 sink 仍逐条 log()
+  *
+  * batch_file_sink：与 spdlog::sinks::basic_file_sink 行为一致的普通文件 sink，另外实现 batch_sink：
+  *  - 逐条写入时与 basic_file_sink 相同（每条一次 fwrite）
+  *  - 批量写入时整批一次 fwrite，超过 stdio 缓冲的大块直接落到一次 write 系统调用
+  *
+  * File：batch_file_sink.hpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#ifndef COREXI_COMMON_PC_BATCH_FILE_SINK_HPP
+#define COREXI_COMMON_PC_BATCH_FILE_SINK_HPP
+
+#include <cstddef>
+#include <mutex>
+#include <spdlog/details/file_helper.h>
+#include <spdlog/details/log_msg.h>
+#include <spdlog/sinks/base_sink.h>
+
+namespace CustomSink
+{
+	class batch_sink
+	{
+	public:
+		virtual ~batch_sink() = default;
+
+		/// 按顺序写入一批日志，低于 sink 级别的由 sink 自行跳过；不刷新（刷新由调用方按 flush_on 决定）
+		virtual void log_batch(const spdlog::details::log_msg* msgs, std::size_t count) = 0;
+	};
+
+	template<typename Mutex>
+	class batch_file_sink : public spdlog::sinks::base_sink<Mutex>, public batch_sink
+	{
+	public:
+		explicit batch_file_sink(const spdlog::filename_t& filename, bool truncate = false)
+		{
+			file_helper_.open(filename, truncate);
+		}
+
+		void log_batch(const spdlog::details::log_msg* msgs, std::size_t count) override
+		{
+			std::lock_guard<Mutex> lock(this->mutex_);
+			batch_buffer_.clear();
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				if (this->should_log(msgs[i].level))
+					this->formatter_->format(msgs[i], batch_buffer_);
+			}
+			if (batch_buffer_.size() > 0)
+				file_helper_.write(batch_buffer_);
+		}
+
+	protected:
+		void sink_it_(const spdlog::details::log_msg& msg) override
+		{
+			spdlog::memory_buf_t formatted;
+			this->formatter_->format(msg, formatted);
+			file_helper_.write(formatted);
+		}
+
+		void flush_() override
+		{
+			file_helper_.flush();
+		}
+
+	private:
+		spdlog::details::file_helper file_helper_;
+		spdlog::memory_buf_t batch_buffer_;// 整批的格式化结果，复用容量，由 mutex_ 保护
+	};
+
+	using batch_file_sink_mt = batch_file_sink<std::mutex>;
+}// namespace CustomSink
+
+#endif// COREXI_COMMON_PC_BATCH_FILE_SINK_HPP
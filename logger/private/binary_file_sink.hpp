@@ -0,0 +1,373 @@
+/*************************************************
+  * 描述：紧凑二进制日志文件sink + 文件格式定义（logger_decode 离线解码工具共用）
+  *
+  * 与文本文件 sink 相比，不再重复写入时间戳文本、[文件:行号][函数] 前缀与常量片段：
+  *  - 调用点（文件、行号、函数）在每个文件段内只写一次，之后用调用点 ID 引用
+  *  - 时间戳写与上一条的纳秒差值（zigzag + varint）
+  *  - 延迟格式化记录（LogRecordWriter）的参数按原始类型落盘（整数 varint），解码时再格式化；
+  *    与同一调用点上一条日志同位置参数相同的字符串（常量片段）只写 1 字节引用
+  *  - 其余 payload（std::any 旧接口、库内部诊断信息）按文本落盘
+  *
+  * 文件由若干段组成（每次打开文件追加写入时开始新的一段），所有整数均为小端：
+  *   段头  ['L''G''R''B'][version:u16][varint len][pattern][varint len][logger name]
+  *         [zigzag varint 浮点小数位数，-1 为最短表示][base time ns:i64]
+  *   调用点 ['S'][varint id][varint line][varint len][file][varint len][func]
+  *   消息  ['M'][varint site id][zigzag varint 时间差 ns][level:u8][varint thread id][kind:u8][正文]
+  *   kind = 0：正文为 [varint len][文本]
+  *   kind = 1：正文为 [varint flags][varint 参数个数] 之后每个参数 [tag:u8][值]，tag 同 LogArgTag：
+  *             Bool/Char 1 字节，WChar 为字符编码值的 varint，Int 为 zigzag varint，UInt 为 varint，Float/Double 为原始 4/8 字节，
+  *             Str 为 [varint len][UTF-8 字节]（宽字符串写入前转为 UTF-8），
+  *             kArgStrRepeat 无值，表示与本段内同一调用点上一条日志同位置的字符串相同
+  *   site id = 0 表示没有位置信息
+  *
+  * 懒创建：构造时不创建文件，首次写入才打开
+  *
+  * File：binary_file_sink.hpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：2026/10/16 — 段头记录浮点小数位数（float_precision），格式版本升为 2
+  * ************************************************/
+#ifndef COREXI_COMMON_PC_BINARY_FILE_SINK_HPP
+#define COREXI_COMMON_PC_BINARY_FILE_SINK_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <logger/logrecord.hpp>
+#include <mutex>
+#include <spdlog/details/file_helper.h>
+#include <spdlog/sinks/base_sink.h>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace CustomSink
+{
+	namespace binary_log
+	{
+		constexpr char kMagic[4] = {'L', 'G', 'R', 'B'};
+		constexpr std::uint16_t kVersion = 2;
+
+		constexpr char kTagSegment = 'L';// 段头与 magic 首字节相同
+		constexpr char kTagSite = 'S';
+		constexpr char kTagMessage = 'M';
+
+		constexpr std::uint8_t kPayloadText = 0;
+		constexpr std::uint8_t kPayloadRecord = 1;
+
+		constexpr std::uint8_t kArgStrRepeat = 0x40;
+		constexpr std::size_t kMaxRepeatString = 256;// 超过该长度的字符串不参与重复引用
+
+		inline void put_bytes(spdlog::memory_buf_t& out, const void* data, std::size_t size)
+		{
+			const auto* p = static_cast<const char*>(data);
+			out.append(p, p + size);
+		}
+
+		inline void put_varint(spdlog::memory_buf_t& out, std::uint64_t value)
+		{
+			char buf[10];
+			std::size_t n = 0;
+			while (value >= 0x80)
+			{
+				buf[n++] = static_cast<char>((value & 0x7F) | 0x80);
+				value >>= 7;
+			}
+			buf[n++] = static_cast<char>(value);
+			out.append(buf, buf + n);
+		}
+
+		inline void put_string(spdlog::memory_buf_t& out, std::string_view str)
+		{
+			put_varint(out, str.size());
+			put_bytes(out, str.data(), str.size());
+		}
+
+		/// 写入/解码两侧共用的重复引用规则：只记住不超过 kMaxRepeatString 的字符串
+		inline void remember_string(std::string& last, std::string_view value)
+		{
+			if (value.size() <= kMaxRepeatString)
+				last.assign(value.data(), value.size());
+			else
+				last.clear();
+		}
+
+		inline std::uint64_t zigzag_encode(std::int64_t value)
+		{
+			return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+		}
+
+		inline std::int64_t zigzag_decode(std::uint64_t value)
+		{
+			return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+		}
+
+		/// 顺序读取器，越界时返回 false，不抛异常
+		class reader
+		{
+		public:
+			explicit reader(std::string_view data)
+				: data_(data) {}
+
+			bool eof() const { return pos_ >= data_.size(); }
+
+			std::size_t pos() const { return pos_; }
+
+			bool get_bytes(void* value, std::size_t size)
+			{
+				if (size > data_.size() - pos_)
+					return false;
+				std::memcpy(value, data_.data() + pos_, size);
+				pos_ += size;
+				return true;
+			}
+
+			bool get_varint(std::uint64_t& value)
+			{
+				value = 0;
+				for (int shift = 0; shift < 64 && pos_ < data_.size(); shift += 7)
+				{
+					const auto byte = static_cast<std::uint8_t>(data_[pos_++]);
+					value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+					if ((byte & 0x80) == 0)
+						return true;
+				}
+				return false;
+			}
+
+			bool get_string(std::string_view& str)
+			{
+				std::uint64_t size;
+				if (!get_varint(size) || size > data_.size() - pos_)
+					return false;
+				str = data_.substr(pos_, static_cast<std::size_t>(size));
+				pos_ += static_cast<std::size_t>(size);
+				return true;
+			}
+
+		private:
+			std::string_view data_;
+			std::size_t pos_ = 0;
+		};
+	}// namespace binary_log
+
+	template<typename Mutex>
+	class binary_file_mt : public spdlog::sinks::base_sink<Mutex>
+	{
+	public:
+		/**
+		 * @param filename 输出文件路径
+		 * @param truncate 是否清空截断，false则追加写入新的一段
+		 * @param pattern 写入段头的输出格式，logger_decode 默认按此格式还原文本
+		 * @param float_precision 写入段头的浮点小数位数，logger_decode 按此还原浮点参数
+		 */
+		explicit binary_file_mt(std::string filename, bool truncate = false,
+								std::string pattern = "[%Y-%m-%d %H:%M:%S.%e][%n][%^%l%$][thread %t]%v",
+								int float_precision = LoggerUtil::kShortestFloat)
+			: filename_(std::move(filename)), truncate_(truncate), pattern_(std::move(pattern)),
+			  float_precision_(float_precision) {}
+
+		const std::string& filename() const { return filename_; }
+
+	protected:
+		void sink_it_(const spdlog::details::log_msg& msg) override
+		{
+			if (!opened_)
+			{
+				file_helper_.open(filename_, truncate_);
+				opened_ = true;
+				begin_segment_(msg);
+			}
+
+			site_state& site = site_(msg.source);
+			const std::int64_t timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+												msg.time.time_since_epoch())
+												.count();
+
+			buf_.push_back(binary_log::kTagMessage);
+			binary_log::put_varint(buf_, site.id);
+			binary_log::put_varint(buf_, binary_log::zigzag_encode(timeNs - lastTimeNs_));
+			buf_.push_back(static_cast<char>(msg.level));
+			binary_log::put_varint(buf_, msg.thread_id);
+			lastTimeNs_ = timeNs;
+
+			const std::string_view payload(msg.payload.data(), msg.payload.size());
+			if (!LoggerUtil::LogRecordReader::isRecord(payload) || !put_record_(LoggerUtil::LogRecordReader(payload), site))
+			{
+				buf_.push_back(static_cast<char>(binary_log::kPayloadText));
+				binary_log::put_string(buf_, payload);
+			}
+
+			file_helper_.write(buf_);
+			buf_.clear();
+		}
+
+		void flush_() override
+		{
+			file_helper_.flush();
+		}
+
+		void set_pattern_(const std::string& pattern) override
+		{
+			pattern_ = pattern;
+			spdlog::sinks::base_sink<Mutex>::set_pattern_(pattern);
+		}
+
+	private:
+		struct site_key
+		{
+			const char* file;
+			int line;
+			const char* func;
+
+			bool operator==(const site_key& other) const
+			{
+				return file == other.file && line == other.line && func == other.func;
+			}
+		};
+
+		struct site_key_hash
+		{
+			std::size_t operator()(const site_key& key) const
+			{
+				std::size_t h = std::hash<const void*>()(key.file);
+				h ^= std::hash<int>()(key.line) + 0x9e3779b9 + (h << 6) + (h >> 2);
+				h ^= std::hash<const void*>()(key.func) + 0x9e3779b9 + (h << 6) + (h >> 2);
+				return h;
+			}
+		};
+
+		struct site_state
+		{
+			std::uint64_t id = 0;
+			std::vector<std::string> strings;// 上一条日志各位置的字符串参数，用于重复引用
+		};
+
+		// 段头：调用点表从零开始，保证每一段都能独立解码
+		void begin_segment_(const spdlog::details::log_msg& msg)
+		{
+			sites_.clear();
+			noSite_.strings.clear();
+			lastTimeNs_ = std::chrono::duration_cast<std::chrono::nanoseconds>(msg.time.time_since_epoch()).count();
+
+			buf_.clear();
+			binary_log::put_bytes(buf_, binary_log::kMagic, sizeof(binary_log::kMagic));
+			binary_log::put_bytes(buf_, &binary_log::kVersion, sizeof(binary_log::kVersion));
+			binary_log::put_string(buf_, pattern_);
+			binary_log::put_string(buf_, std::string_view(msg.logger_name.data(), msg.logger_name.size()));
+			binary_log::put_varint(buf_, binary_log::zigzag_encode(float_precision_));
+			binary_log::put_bytes(buf_, &lastTimeNs_, sizeof(lastTimeNs_));
+		}
+
+		// 调用点以字面量指针为键（__FILE__/__FUNCTION__ 地址在进程内固定），首次出现时写入元数据
+		site_state& site_(const spdlog::source_loc& source)
+		{
+			if (source.empty())
+				return noSite_;
+
+			const site_key key{source.filename, source.line, source.funcname};
+			auto it = sites_.find(key);
+			if (it != sites_.end())
+				return it->second;
+
+			site_state& site = sites_[key];
+			site.id = sites_.size();
+
+			buf_.push_back(binary_log::kTagSite);
+			binary_log::put_varint(buf_, site.id);
+			binary_log::put_varint(buf_, static_cast<std::uint64_t>(source.line));
+			binary_log::put_string(buf_, source.filename);
+			binary_log::put_string(buf_, source.funcname ? source.funcname : "");
+			return site;
+		}
+
+		// 逐个参数重新编码；记录损坏时回滚，由调用方按文本落盘
+		bool put_record_(const LoggerUtil::LogRecordReader& reader, site_state& site)
+		{
+			const std::size_t start = buf_.size();
+			buf_.push_back(static_cast<char>(binary_log::kPayloadRecord));
+			binary_log::put_varint(buf_, reader.flags());
+			binary_log::put_varint(buf_, reader.argCount());
+			if (site.strings.size() < reader.argCount())
+				site.strings.resize(reader.argCount());
+
+			std::size_t index = 0;
+			const bool ok = reader.forEachArg([&](auto value) { put_arg_(site.strings[index++], value); });
+			if (!ok)
+			{
+				// 已编码的参数可能更新了重复引用表，而解码端看不到这条记录：清空后下一条按完整字符串写出
+				buf_.resize(start);
+				for (std::string& last: site.strings)
+					last.clear();
+			}
+			return ok;
+		}
+
+		template<typename T>
+		void put_arg_(std::string& last, T value)
+		{
+			using LoggerUtil::LogArgTag;
+			if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, char>)
+			{
+				buf_.push_back(static_cast<char>(std::is_same_v<T, bool> ? LogArgTag::Bool : LogArgTag::Char));
+				buf_.push_back(static_cast<char>(value));
+			}
+			else if constexpr (std::is_same_v<T, wchar_t>)
+			{
+				buf_.push_back(static_cast<char>(LogArgTag::WChar));
+				binary_log::put_varint(buf_, static_cast<std::uint64_t>(static_cast<std::make_unsigned_t<wchar_t>>(value)));
+			}
+			else if constexpr (std::is_same_v<T, std::int64_t>)
+			{
+				buf_.push_back(static_cast<char>(LogArgTag::Int));
+				binary_log::put_varint(buf_, binary_log::zigzag_encode(value));
+			}
+			else if constexpr (std::is_same_v<T, std::uint64_t>)
+			{
+				buf_.push_back(static_cast<char>(LogArgTag::UInt));
+				binary_log::put_varint(buf_, value);
+			}
+			else if constexpr (std::is_floating_point_v<T>)
+			{
+				buf_.push_back(static_cast<char>(std::is_same_v<T, float> ? LogArgTag::Float : LogArgTag::Double));
+				binary_log::put_bytes(buf_, &value, sizeof(value));
+			}
+			else if constexpr (std::is_same_v<T, std::wstring_view>)
+			{
+				wide_utf8_.clear();
+				LoggerUtil::appendUtf8(wide_utf8_, value);
+				put_arg_(last, std::string_view(wide_utf8_));
+			}
+			else
+			{
+				if (!last.empty() && last == value)
+				{
+					buf_.push_back(static_cast<char>(binary_log::kArgStrRepeat));
+					return;
+				}
+				buf_.push_back(static_cast<char>(LogArgTag::Str));
+				binary_log::put_string(buf_, value);
+				binary_log::remember_string(last, value);
+			}
+		}
+
+	private:
+		spdlog::details::file_helper file_helper_;
+		std::string filename_;
+		bool truncate_;
+		std::string pattern_;
+		int float_precision_;
+		bool opened_ = false;
+
+		std::unordered_map<site_key, site_state, site_key_hash> sites_;
+		site_state noSite_;
+		std::int64_t lastTimeNs_ = 0;
+		spdlog::memory_buf_t buf_;
+		std::string wide_utf8_;// 宽字符串参数转码缓冲
+	};
+
+}// namespace CustomSink
+
+#endif// COREXI_COMMON_PC_BINARY_FILE_SINK_HPP
@@ -0,0 +1,326 @@
+/*************************************************
+  * 描述：配置文件监视器
+  *
+  * 后台线程监视配置文件的变化，合并一段时间内的连续修改（防抖）后回调一次：
+  *  - Linux 下用 inotify 监视文件所在目录（编辑器常以“写临时文件 + rename”的方式保存，直接监视文件会丢失后续事件）
+  *  - 其他平台或 inotify 不可用时，按固定间隔轮询文件的修改时间与大小
+  *  - 回调在监视线程上执行，返回 false 时停止监视；stop() 不能在持有回调所需的锁时调用
+  *
+  * File：config_watcher.hpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#ifndef COREXI_COMMON_PC_CONFIG_WATCHER_HPP
+#define COREXI_COMMON_PC_CONFIG_WATCHER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+class ConfigWatcher
+{
+public:
+	using clock = std::chrono::steady_clock;
+	/// 参数为本轮修改首次被检测到的时刻，返回 false 时停止监视
+	using ChangeHandler = std::function<bool(clock::time_point detectedAt)>;
+
+	ConfigWatcher() = default;
+	ConfigWatcher(const ConfigWatcher&) = delete;
+	ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+	~ConfigWatcher()
+	{
+		stop();
+	}
+
+	/**
+	 * 开始监视，已在监视时先停止；返回后发生的修改都会被检测到
+	 * @param path 配置文件路径
+	 * @param debounce 最后一次修改后等待的时间，期间的修改合并为一次回调
+	 * @param pollInterval 轮询模式下检查文件的间隔
+	 * @param handler 变化回调
+	 */
+	void start(const std::string& path, std::chrono::milliseconds debounce, std::chrono::milliseconds pollInterval,
+			   ChangeHandler handler)
+	{
+		stop();
+		m_path = std::filesystem::absolute(path);
+		m_handler = std::move(handler);
+		setDebounce(debounce);
+		setPollInterval(pollInterval);
+		m_stop = false;
+		// 在调用线程上建立监视，避免与随后的修改竞争
+#ifdef __linux__
+		m_inotify.store(setupInotify(), std::memory_order_relaxed);
+#endif
+		m_lastStamp = stamp();
+		m_running.store(true, std::memory_order_release);
+		m_thread = std::thread(&ConfigWatcher::run, this);
+	}
+
+	/// 停止监视并等待监视线程退出（在监视线程自身上调用时只请求停止）
+	void stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+#ifdef __linux__
+			if (m_wakeFd >= 0)
+			{
+				const std::uint64_t one = 1;
+				[[maybe_unused]] const auto written = ::write(m_wakeFd, &one, sizeof(one));
+			}
+#endif
+		}
+		m_wake.notify_all();
+		if (m_thread.joinable() && m_thread.get_id() != std::this_thread::get_id())
+		{
+			m_thread.join();
+		}
+	}
+
+	bool running() const
+	{
+		return m_running.load(std::memory_order_acquire);
+	}
+
+	/// 当前线程是否为监视线程（即在变化回调中）
+	bool onWatcherThread() const
+	{
+		return m_thread.get_id() == std::this_thread::get_id();
+	}
+
+	/// 正在监视的文件（绝对路径）
+	const std::filesystem::path& path() const
+	{
+		return m_path;
+	}
+
+	void setDebounce(std::chrono::milliseconds debounce)
+	{
+		m_debounceMs.store(std::max<long long>(debounce.count(), 0), std::memory_order_relaxed);
+	}
+
+	void setPollInterval(std::chrono::milliseconds interval)
+	{
+		m_pollMs.store(std::max<long long>(interval.count(), 10), std::memory_order_relaxed);
+	}
+
+	/// 当前是否使用 inotify（false 表示轮询）
+	bool usingInotify() const
+	{
+		return m_inotify.load(std::memory_order_relaxed);
+	}
+
+private:
+	std::chrono::milliseconds debounce() const
+	{
+		return std::chrono::milliseconds(m_debounceMs.load(std::memory_order_relaxed));
+	}
+
+	void run()
+	{
+#ifdef __linux__
+		if (usingInotify())
+			runInotify();
+		else
+#endif
+			runPolling();
+		m_running.store(false, std::memory_order_release);
+	}
+
+	/// 防抖到期后调用回调，返回是否继续监视
+	bool fire(clock::time_point detectedAt)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_stop)
+				return false;
+		}
+		return m_handler(detectedAt);
+	}
+
+#ifdef __linux__
+	/// 创建 inotify 监视与唤醒用的 eventfd，失败时返回 false，改用轮询
+	bool setupInotify()
+	{
+		const int inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (inotifyFd < 0)
+			return false;
+		const int wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (wakeFd < 0 || ::inotify_add_watch(inotifyFd, m_path.parent_path().c_str(),
+											   IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE) < 0)
+		{
+			if (wakeFd >= 0)
+				::close(wakeFd);
+			::close(inotifyFd);
+			return false;
+		}
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_inotifyFd = inotifyFd;
+		m_wakeFd = wakeFd;
+		return true;
+	}
+
+	void runInotify()
+	{
+		int inotifyFd;
+		int wakeFd;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			inotifyFd = m_inotifyFd;
+			wakeFd = m_wakeFd;
+		}
+		const std::string fileName = m_path.filename().string();
+		alignas(inotify_event) char buffer[4096];
+		bool pending = false;
+		clock::time_point detectedAt;
+		clock::time_point deadline;
+		for (;;)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (m_stop)
+					break;
+			}
+			int timeout = -1;
+			if (pending)
+			{
+				const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - clock::now());
+				timeout = static_cast<int>(std::max<long long>(left.count(), 0));
+			}
+			pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {wakeFd, POLLIN, 0}};
+			const int ready = ::poll(fds, 2, timeout);
+			if (ready < 0)
+				continue;// EINTR
+			if (fds[1].revents & POLLIN)
+				continue;// stop() 唤醒，回到循环开头检查
+			if (fds[0].revents & POLLIN)
+			{
+				ssize_t length;
+				while ((length = ::read(inotifyFd, buffer, sizeof(buffer))) > 0)
+				{
+					for (char* p = buffer; p < buffer + length;)
+					{
+						const auto* event = reinterpret_cast<const inotify_event*>(p);
+						if (event->len > 0 && fileName == event->name)
+						{
+							const auto now = clock::now();
+							if (!pending)
+								detectedAt = now;
+							pending = true;
+							deadline = now + debounce();
+						}
+						p += sizeof(inotify_event) + event->len;
+					}
+				}
+				continue;
+			}
+			if (pending && clock::now() >= deadline)
+			{
+				pending = false;
+				if (!fire(detectedAt))
+					break;
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_inotifyFd = -1;
+			m_wakeFd = -1;
+		}
+		::close(wakeFd);
+		::close(inotifyFd);
+	}
+#endif
+
+	void runPolling()
+	{
+		auto lastStamp = m_lastStamp;
+		bool pending = false;
+		clock::time_point detectedAt;
+		clock::time_point deadline;
+		std::unique_lock<std::mutex> lock(m_mutex);
+		for (;;)
+		{
+			const auto interval = std::chrono::milliseconds(m_pollMs.load(std::memory_order_relaxed));
+			const auto wakeAt = pending ? std::min(clock::now() + interval, deadline) : clock::now() + interval;
+			if (m_wake.wait_until(lock, wakeAt, [this] { return m_stop; }))
+				break;
+			lock.unlock();
+
+			const auto now = clock::now();
+			const auto current = stamp();
+			if (current != lastStamp)
+			{
+				lastStamp = current;
+				if (!pending)
+					detectedAt = now;
+				pending = true;
+				deadline = now + debounce();
+			}
+			else if (pending && now >= deadline)
+			{
+				pending = false;
+				if (!fire(detectedAt))
+					return;
+			}
+			lock.lock();
+		}
+	}
+
+	/// 文件的修改时间与大小，文件不存在时为空
+	struct Stamp
+	{
+		std::filesystem::file_time_type time{};
+		std::uintmax_t size = 0;
+
+		bool operator!=(const Stamp& other) const
+		{
+			return time != other.time || size != other.size;
+		}
+	};
+
+	Stamp stamp() const
+	{
+		std::error_code ec;
+		Stamp result;
+		result.time = std::filesystem::last_write_time(m_path, ec);
+		if (ec)
+			return {};
+		result.size = std::filesystem::file_size(m_path, ec);
+		return result;
+	}
+
+	std::filesystem::path m_path;
+	ChangeHandler m_handler;
+	Stamp m_lastStamp;// 开始监视时的文件状态（轮询模式的比较基准）
+	std::atomic<long long> m_debounceMs{200};
+	std::atomic<long long> m_pollMs{1000};
+	std::atomic<bool> m_running{false};
+	std::atomic<bool> m_inotify{false};
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	bool m_stop = false;
+	int m_inotifyFd = -1;
+	int m_wakeFd = -1;// inotify 模式下唤醒 poll 的 eventfd，受 m_mutex 保护
+	std::thread m_thread;
+};
+
+#endif// COREXI_COMMON_PC_CONFIG_WATCHER_HPP
@@ -12,6 +12,8 @@
   *  - 懒创建：构造时不创建空文件，首次写入才创建/打开 stem.log
   *  - rotate_on_open=true：首次写入前若 stem.log 已存在，则先做一次滚动（rename链条），再写新的 stem.log
   *  - strict_count_on_open=true：首次打开文件时统计已有行数，严格保证每个文件总行数 <= max_count
+  *  - 批量写入（batch_sink）：同一文件内的日志攒在一块缓冲中，滚动前或整批结束时一次写出
+  *  - 统计（counted_sink）：写入条数 / 字节数、滚动次数与耗时、刷新次数，在 sink 锁内以 relaxed 原子加更新
   *
   * 注意：
   *  - strict_count_on_open 只在“打开文件”时扫描行数，不会每条日志都扫
@@ -19,6 +21,8 @@
 #ifndef COREXI_COMMON_PC_COUNT_ROTATING_SPDLOG_STYLE_SINK_HPP
 #define COREXI_COMMON_PC_COUNT_ROTATING_SPDLOG_STYLE_SINK_HPP
 
+#include "batch_file_sink.hpp"
+#include "sink_counters.hpp"
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
@@ -44,7 +48,7 @@ namespace CustomSink
 	}
 
 	template<typename Mutex>
-	class count_rotating_file_mt : public spdlog::sinks::base_sink<Mutex>
+	class count_rotating_file_mt : public spdlog::sinks::base_sink<Mutex>, public batch_sink, public counted_sink
 	{
 	public:
 		// base_filename: "logs/app.log" 或 "logs/app"
@@ -77,8 +81,38 @@ namespace CustomSink
 			rotated_on_open_done_ = false;
 		}
 
+		void log_batch(const spdlog::details::log_msg* msgs, std::size_t count) override
+		{
+			std::lock_guard<Mutex> lock(this->mutex_);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				if (this->should_log(msgs[i].level))
+					append_(msgs[i]);
+			}
+			write_pending_();
+		}
+
+		const sink_counters& counters() const override
+		{
+			return counters_;
+		}
+
 	protected:
 		void sink_it_(const spdlog::details::log_msg& msg) override
+		{
+			append_(msg);
+			write_pending_();
+		}
+
+		void flush_() override
+		{
+			file_helper_.flush();
+			counters_.on_flush();
+		}
+
+	private:
+		// 格式化一条日志追加到 pending_，必要时先滚动（滚动前写出 pending_ 中属于旧文件的部分）
+		void append_(const spdlog::details::log_msg& msg)
 		{
 			// rotate_on_open：第一次真正写入前...
 			if (!rotated_on_open_done_)
@@ -118,10 +152,8 @@ namespace CustomSink
 				ensure_opened_for_write_();
 			}
 
-			spdlog::memory_buf_t buf;
-			this->formatter_->format(msg, buf);
-
-			file_helper_.write(buf);
+			this->formatter_->format(msg, pending_);
+			++pending_count_;
 
 			++log_count_;
 
@@ -132,12 +164,16 @@ namespace CustomSink
 			}
 		}
 
-		void flush_() override
+		void write_pending_()
 		{
-			file_helper_.flush();
+			if (pending_.size() == 0)
+				return;
+			file_helper_.write(pending_);
+			counters_.on_write(pending_count_, pending_.size());
+			pending_.clear();
+			pending_count_ = 0;
 		}
 
-	private:
 		// logs/app.log
 		fs::path base_path_() const
 		{
@@ -228,15 +264,20 @@ namespace CustomSink
 		// 不打开新 base（懒创建，下一条写入才会打开）
 		void rotate_files_()
 		{
-			file_helper_.close();
-			opened_ = false;
-			log_count_ = 0;
-
+			write_pending_();
 			if (max_files_ == 0)
 			{
+				file_helper_.close();
+				opened_ = false;
+				log_count_ = 0;
 				return;
 			}
 
+			rotation_timer timer(counters_);
+			file_helper_.close();
+			opened_ = false;
+			log_count_ = 0;
+
 			std::error_code ec;
 
 			// 删除最老的 stem.max_files.log
@@ -277,6 +318,9 @@ namespace CustomSink
 
 	private:
 		spdlog::details::file_helper file_helper_;
+		spdlog::memory_buf_t pending_;// 已格式化、尚未写出的日志（均属于当前打开的文件）
+		std::size_t pending_count_ = 0;// pending_ 中的日志条数
+		sink_counters counters_;
 
 		fs::path dir_;
 		std::string stem_;
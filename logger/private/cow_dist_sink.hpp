@@ -0,0 +1,171 @@
+/*************************************************
+  * 描述：写时复制（RCU）的运行时分发sink
+  *
+  * 承载运行时增删的 sink（回调、流输出），作为 logger（或延迟格式化分发 sink）的一个固定子 sink：
+  *  - 读者（打日志的线程 / 异步 worker）在 epoch 临界区内原子读取不可变的 sink 列表快照后遍历，不加锁
+  *  - 写者复制当前列表、修改后整体发布，旧列表挂入待回收队列
+  *  - reclaim() 等待仍可能持有旧列表的读者离开后释放旧列表；调用方应在释放自身的锁之后调用，
+  *    否则在回调中增删回调的读者会与之互相等待
+  *
+  * File：cow_dist_sink.hpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#ifndef COREXI_COMMON_PC_COW_DIST_SINK_HPP
+#define COREXI_COMMON_PC_COW_DIST_SINK_HPP
+
+#include "epoch.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <spdlog/pattern_formatter.h>
+#include <spdlog/sinks/sink.h>
+#include <vector>
+
+namespace CustomSink
+{
+	class cow_dist_sink : public spdlog::sinks::sink
+	{
+	public:
+		using sink_list = std::vector<std::shared_ptr<spdlog::sinks::sink>>;
+
+		cow_dist_sink() = default;
+		cow_dist_sink(const cow_dist_sink&) = delete;
+		cow_dist_sink& operator=(const cow_dist_sink&) = delete;
+
+		~cow_dist_sink() override
+		{
+			delete sinks_.load(std::memory_order_acquire);
+		}
+
+		void log(const spdlog::details::log_msg& msg) override
+		{
+			EpochGuard guard;
+			const sink_list* sinks = sinks_.load(std::memory_order_acquire);
+			if (!sinks)
+				return;
+			for (const auto& sink: *sinks)
+			{
+				if (sink->should_log(msg.level))
+				{
+					sink->log(msg);
+				}
+			}
+		}
+
+		void flush() override
+		{
+			EpochGuard guard;
+			const sink_list* sinks = sinks_.load(std::memory_order_acquire);
+			if (!sinks)
+				return;
+			for (const auto& sink: *sinks)
+			{
+				sink->flush();
+			}
+		}
+
+		// 与 dist_sink 一致：格式只下发给当前已挂载的子 sink
+		void set_pattern(const std::string& pattern) override
+		{
+			set_formatter(std::make_unique<spdlog::pattern_formatter>(pattern));
+		}
+
+		void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			const sink_list* sinks = sinks_.load(std::memory_order_acquire);
+			if (!sinks)
+				return;
+			for (const auto& sink: *sinks)
+			{
+				sink->set_formatter(sink_formatter->clone());
+			}
+		}
+
+		void add_sink(std::shared_ptr<spdlog::sinks::sink> sink)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			auto next = copy_();
+			next->push_back(std::move(sink));
+			publish_(std::move(next));
+		}
+
+		void remove_sink(const std::shared_ptr<spdlog::sinks::sink>& sink)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			auto next = copy_();
+			next->erase(std::remove(next->begin(), next->end(), sink), next->end());
+			publish_(std::move(next));
+		}
+
+		/**
+		 * 释放已被替换的旧列表，返回后被移除的 sink 不会再被本 sink 调用
+		 * 当前线程自身处于 epoch 临界区（如在回调中增删回调）时无法等待，旧列表留到下一次 reclaim 释放
+		 */
+		void reclaim()
+		{
+			std::vector<std::unique_ptr<sink_list>> pending;
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				pending.swap(retired_);
+			}
+			if (pending.empty())
+				return;
+			if (!EpochDomain::instance().synchronize())
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				std::move(pending.begin(), pending.end(), std::back_inserter(retired_));
+			}
+		}
+
+		std::size_t size() const
+		{
+			EpochGuard guard;
+			const sink_list* sinks = sinks_.load(std::memory_order_acquire);
+			return sinks ? sinks->size() : 0;
+		}
+
+		/// 在 epoch 临界区内遍历当前已挂载的子 sink（统计使用），不加锁
+		template<typename Fn>
+		void for_each(Fn&& fn) const
+		{
+			EpochGuard guard;
+			const sink_list* sinks = sinks_.load(std::memory_order_acquire);
+			if (!sinks)
+				return;
+			for (const auto& sink: *sinks)
+			{
+				fn(sink);
+			}
+		}
+
+	private:
+		std::unique_ptr<sink_list> copy_() const
+		{
+			const sink_list* current = sinks_.load(std::memory_order_relaxed);
+			return current ? std::make_unique<sink_list>(*current) : std::make_unique<sink_list>();
+		}
+
+		void publish_(std::unique_ptr<sink_list> next)
+		{
+			if (next->empty())
+			{
+				next.reset();// 空列表发布为 nullptr，读者只做一次原子读
+			}
+			std::unique_ptr<sink_list> old(sinks_.exchange(next.release(), std::memory_order_acq_rel));
+			if (old)
+			{
+				retired_.push_back(std::move(old));
+			}
+		}
+
+		std::atomic<sink_list*> sinks_{nullptr};
+		std::vector<std::unique_ptr<sink_list>> retired_;
+		std::mutex mutex_;// 串行化写者
+	};
+}// namespace CustomSink
+
+#endif// COREXI_COMMON_PC_COW_DIST_SINK_HPP
@@ -15,6 +15,8 @@
  *   - “无后缀 .log”永远代表当前文件，程序结束时也应该存在
  *   - size 滚动仅在“写入前”触发；写完后不滚动
  *   - max_files == 0：禁用 size 滚动，永远追加写当天 base 文件，不清空
+ *
+ * 统计（counted_sink）：写入条数 / 字节数、日切与 size 滚动的次数与耗时、刷新次数，在 sink 锁内以 relaxed 原子加更新
  ************************************************/
 #ifndef COREXI_COMMON_PC_DAILY_SIZE_ROTATING_SINK_NOQT_HPP
 #define COREXI_COMMON_PC_DAILY_SIZE_ROTATING_SINK_NOQT_HPP
@@ -34,6 +36,8 @@
 #include <spdlog/details/file_helper.h>
 #include <spdlog/sinks/base_sink.h>
 
+#include "sink_counters.hpp"
+
 namespace CustomSink
 {
 namespace fs = std::filesystem;
@@ -243,7 +247,7 @@ static inline std::string replace_all_(std::string s, std::string_view from, std
 
 // ---------------- Sink: daily + size rotating ----------------
 template<typename Mutex>
-class daily_size_rotating_file_mt : public spdlog::sinks::base_sink<Mutex>
+class daily_size_rotating_file_mt : public spdlog::sinks::base_sink<Mutex>, public counted_sink
 {
 public:
     // max_size_bits: bit（内部转 bytes，向上取整）
@@ -283,6 +287,11 @@ public:
         update_targets_for_now_();
     }
 
+    const sink_counters& counters() const override
+    {
+        return counters_;
+    }
+
 protected:
     void sink_it_(const spdlog::details::log_msg& msg) override
     {
@@ -322,6 +331,7 @@ protected:
 
         file_helper_.write(buf);
         current_size_bytes_ += will_write;
+        counters_.on_write(1, will_write);
 
         // 6) 关键：写后不滚动（保证无后缀当前文件始终存在）
     }
@@ -329,6 +339,7 @@ protected:
     void flush_() override
     {
         file_helper_.flush();
+        counters_.on_flush();
     }
 
 private:
@@ -391,6 +402,7 @@ private:
             return;
 
         // 到点日切：关闭当前文件，切换到新日期组
+        rotation_timer timer(counters_);
         close_file_();
 
         current_basename_ = make_basename_for_tp_(tp);
@@ -427,6 +439,7 @@ private:
     {
         if (max_files_ == 0) return;
 
+        rotation_timer timer(counters_);
         close_file_();
 
         std::error_code ec;
@@ -486,6 +499,8 @@ private:
     uint64_t current_size_bytes_ = 0;
     bool opened_ = false;
     bool rotated_on_open_done_ = false;
+
+    sink_counters counters_;
 };
 
 } // namespace CustomSink
@@ -0,0 +1,94 @@
+/*************************************************
+  * 描述：延迟格式化的分发sink
+  *
+  * 延迟格式化模式下作为 logger 唯一的 sink（异步时运行在线程池 worker 上）：
+  *  - payload 为 LogRecordWriter 写出的记录时，在 worker 上完成参数转换与拼接，
+  *    再把格式化后的文本分发给真正的子 sink（控制台、文件、回调等）
+  *  - payload 为普通文本（std::any 旧接口、库内部诊断信息）时直接透传
+  *  - record_sinks（如 binary_file_mt）直接收到原始记录，不经过文本格式化
+  *
+  * 解码缓冲为成员变量，由 base_sink 的互斥锁保护，多 worker 线程时同样安全
+  *
+  * File：deferred_format_sink.hpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#ifndef COREXI_COMMON_PC_DEFERRED_FORMAT_SINK_HPP
+#define COREXI_COMMON_PC_DEFERRED_FORMAT_SINK_HPP
+
+#include "record_text.hpp"
+#include <memory>
+#include <mutex>
+#include <spdlog/sinks/dist_sink.h>
+#include <string_view>
+#include <vector>
+
+namespace CustomSink
+{
+	class deferred_format_sink : public spdlog::sinks::dist_sink<std::mutex>
+	{
+	public:
+		/**
+		 * @param sinks 接收格式化后文本的子 sink
+		 * @param record_sinks 直接接收原始记录的子 sink（如 binary_file_mt），可为空
+		 * @param float_precision 解码记录时浮点数的小数位数，-1 为最短往返表示
+		 */
+		explicit deferred_format_sink(std::vector<std::shared_ptr<spdlog::sinks::sink>> sinks,
+									  std::vector<std::shared_ptr<spdlog::sinks::sink>> record_sinks = {},
+									  int float_precision = LoggerUtil::kShortestFloat)
+			: spdlog::sinks::dist_sink<std::mutex>(std::move(sinks)), record_sinks_(std::move(record_sinks)),
+			  float_precision_(float_precision) {}
+
+	protected:
+		void sink_it_(const spdlog::details::log_msg& msg) override
+		{
+			for (auto& record_sink: record_sinks_)
+			{
+				if (record_sink->should_log(msg.level))
+				{
+					record_sink->log(msg);
+				}
+			}
+
+			const std::string_view payload(msg.payload.data(), msg.payload.size());
+			if (!LoggerUtil::LogRecordReader::isRecord(payload))
+			{
+				spdlog::sinks::dist_sink<std::mutex>::sink_it_(msg);
+				return;
+			}
+
+			decoded_.clear();
+			format_record_text(LoggerUtil::LogRecordReader(payload), msg.source, decoded_, float_precision_);
+
+			spdlog::details::log_msg decodedMsg(msg);
+			decodedMsg.payload = spdlog::string_view_t(decoded_.data(), decoded_.size());
+			spdlog::sinks::dist_sink<std::mutex>::sink_it_(decodedMsg);
+		}
+
+		void flush_() override
+		{
+			spdlog::sinks::dist_sink<std::mutex>::flush_();
+			for (auto& record_sink: record_sinks_)
+			{
+				record_sink->flush();
+			}
+		}
+
+		void set_formatter_(std::unique_ptr<spdlog::formatter> sink_formatter) override
+		{
+			for (auto& record_sink: record_sinks_)
+			{
+				record_sink->set_formatter(sink_formatter->clone());
+			}
+			spdlog::sinks::dist_sink<std::mutex>::set_formatter_(std::move(sink_formatter));
+		}
+
+	private:
+		std::vector<std::shared_ptr<spdlog::sinks::sink>> record_sinks_;
+		int float_precision_;
+		spdlog::memory_buf_t decoded_;
+	};
+}// namespace CustomSink
+
+#endif// COREXI_COMMON_PC_DEFERRED_FORMAT_SINK_HPP
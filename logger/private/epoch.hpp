@@ -0,0 +1,167 @@
+/*************************************************
+  * 描述：基于 epoch 的读侧无争用内存回收（RCU 风格）
+  *
+  * 读者（日志热路径）：EpochGuard 进入临界区 -> 原子读裸指针 -> 使用 -> 离开临界区
+  *  - 只写本线程独占缓存行上的 epoch 标记，不修改任何共享引用计数，多线程同时打日志不会争抢同一缓存行
+  *  - 支持嵌套（如同步回调中再次打日志），只有最外层更新标记
+  * 写者（配置切换等低频操作）：先原子发布新指针，再 synchronize() 等待仍处于旧 epoch 的读者全部离开，
+  * 之后即可安全释放旧对象
+  *
+  * 每个线程首次进入时登记一条记录，线程退出后记录标记为空闲、供新线程复用；记录本身不释放，
+  * 因此线程退出与静态对象析构的先后顺序无关
+  *
+  * File：epoch.hpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#ifndef COREXI_COMMON_PC_EPOCH_HPP
+#define COREXI_COMMON_PC_EPOCH_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+class EpochDomain
+{
+public:
+	/// 进程内唯一的回收域，所有受 epoch 保护的对象共用
+	static EpochDomain& instance()
+	{
+		static EpochDomain* domain = new EpochDomain;// 有意不析构，见文件头说明
+		return *domain;
+	}
+
+	EpochDomain(const EpochDomain&) = delete;
+	EpochDomain& operator=(const EpochDomain&) = delete;
+
+	void enter()
+	{
+		Record& record = local();
+		if (record.depth++ == 0)
+		{
+			record.epoch.store(m_epoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+			// 标记必须先于随后对受保护指针的读取对写者可见
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+		}
+	}
+
+	void leave()
+	{
+		Record& record = local();
+		if (--record.depth == 0)
+		{
+			record.epoch.store(0, std::memory_order_release);
+		}
+	}
+
+	/// 当前线程是否处于临界区内
+	bool inCritical()
+	{
+		return local().depth != 0;
+	}
+
+	/**
+	 * 等待调用前已进入临界区的读者全部离开；调用前应已发布新指针
+	 * @return false 表示当前线程自身处于临界区（如在同步回调中切换配置），无法等待，调用方应推迟释放
+	 */
+	bool synchronize()
+	{
+		if (inCritical())
+			return false;
+
+		const std::uint64_t target = m_epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		for (Record* record = m_head.load(std::memory_order_acquire); record; record = record->next)
+		{
+			for (;;)
+			{
+				const std::uint64_t epoch = record->epoch.load(std::memory_order_acquire);
+				if (epoch == 0 || epoch >= target)
+					break;
+				std::this_thread::yield();
+			}
+		}
+		return true;
+	}
+
+private:
+	struct alignas(64) Record
+	{
+		std::atomic<std::uint64_t> epoch{0};// 0 表示不在临界区
+		unsigned depth = 0;// 仅所属线程访问
+		std::atomic<bool> inUse{true};
+		Record* next = nullptr;
+	};
+
+	// 线程退出时归还记录
+	struct Holder
+	{
+		Record* record;
+
+		explicit Holder(EpochDomain& domain)
+			: record(domain.acquireRecord()) {}
+
+		~Holder()
+		{
+			record->depth = 0;
+			record->epoch.store(0, std::memory_order_release);
+			record->inUse.store(false, std::memory_order_release);
+		}
+	};
+
+	EpochDomain() = default;
+
+	Record& local()
+	{
+		thread_local Holder holder(*this);
+		return *holder.record;
+	}
+
+	Record* acquireRecord()
+	{
+		for (Record* record = m_head.load(std::memory_order_acquire); record; record = record->next)
+		{
+			bool expected = false;
+			if (!record->inUse.load(std::memory_order_relaxed) &&
+				record->inUse.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+			{
+				return record;
+			}
+		}
+		// 只在链表头插入，遍历中的写者最多漏看新记录，而新记录上的读者必然读到新指针
+		auto* record = new Record;
+		record->next = m_head.load(std::memory_order_relaxed);
+		while (!m_head.compare_exchange_weak(record->next, record, std::memory_order_release, std::memory_order_relaxed))
+		{
+		}
+		return record;
+	}
+
+	std::atomic<std::uint64_t> m_epoch{1};
+	std::atomic<Record*> m_head{nullptr};
+};
+
+/// 作用域内处于 epoch 临界区，其间读到的受保护指针不会被释放
+class EpochGuard
+{
+public:
+	EpochGuard()
+		: m_domain(EpochDomain::instance())
+	{
+		m_domain.enter();
+	}
+
+	~EpochGuard()
+	{
+		m_domain.leave();
+	}
+
+	EpochGuard(const EpochGuard&) = delete;
+	EpochGuard& operator=(const EpochGuard&) = delete;
+
+private:
+	EpochDomain& m_domain;
+};
+
+#endif// COREXI_COMMON_PC_EPOCH_HPP
@@ -1,7 +1,12 @@
 #include "logger_p.h"
+#include "async_callback_sink.hpp"
+#include "batch_file_sink.hpp"
+#include "binary_file_sink.hpp"
 #include "count_rotating_file_mt_sink.hpp"
 // #include "daily_dir_size_rotating_file_sink.hpp"
 #include "daily_size_rotating_file_mt_sink.hpp"
+#include "per_thread_async_logger.hpp"
+#include "thread_tuning.hpp"
 #include "yamltool/yamlnode.h"
 #include "yamltool/yamltool.h"
 
@@ -9,14 +14,15 @@
 #include <spdlog/async.h>
 #include <spdlog/async_logger.h>
 #include <spdlog/logger.h>
-#include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/callback_sink.h>
 #include <spdlog/sinks/daily_file_sink.h>
+#include <spdlog/sinks/null_sink.h>
 #include <spdlog/sinks/ostream_sink.h>
 #include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
 // #include <QString>
+#include <algorithm>
 #include <cstdarg>
 #include <cwctype>
 #include <filesystem>
@@ -69,7 +75,7 @@ const std::string SINK_TYPE_WINCOLOR = "wincolor"; // Windows 控制台彩色输
 const std::string SINK_TYPE_SYSLOG = "syslog"; // Linux/Unix 系统 syslog
 const std::string SINK_TYPE_ANDROID = "android"; // Android logcat
 
-const std::string SINK_TYPE_NULL = "null"; // 黑洞 sink，丢弃日志
+const std::string SINK_TYPE_NULL = "null"; // 黑洞 sink，丢弃日志 // 目前启用----------------
 
 // ============================================================================
 // 4. 自定义sink
@@ -78,142 +84,251 @@ const std::string SINK_TYPE_COUNT_ROTATING_FILE_MT = "count_rotating_file_mt";
 // 按照日志条数进行滚动的日志sink // 目前启用----------------
 const std::string SINK_TYPE_DAILY_SIZE_ROTATING_FILE_MT = "daily_size_rotating_file_mt";
 // 按照日志条数进行滚动的日期日志sink // 目前启用----------------
+const std::string SINK_TYPE_BINARY_FILE_MT = "binary_file_mt";
+// 紧凑二进制日志文件sink，需用 logger_decode 还原为文本 // 目前启用----------------
 // ------------------------------------------------------------------------------
 
+namespace
+{
+    /// 解析 async_overflow_policy 取值，无法识别时返回 fallback
+    spdlog::async_overflow_policy parseOverflowPolicy(const std::string& policyStr,
+                                                      spdlog::async_overflow_policy fallback)
+    {
+        if (policyStr == "block")
+            return spdlog::async_overflow_policy::block;
+        if (policyStr == "overrun_oldest")
+            return spdlog::async_overflow_policy::overrun_oldest;
+        if (policyStr == "discard_new")
+            return spdlog::async_overflow_policy::discard_new;
+        std::cout << "[LogPrivate] 未知的 async_overflow_policy: " << policyStr << std::endl;
+        return fallback;
+    }
+
+    /// logger 级过滤并按级别计数：通过的计入 accepted，被过滤的计入 filtered
+    bool admit(const spdlog::logger& logger, spdlog::level::level_enum level)
+    {
+        auto& statistics = LogStatistics::instance();
+        if (!logger.should_log(level))
+        {
+            statistics.filtered.add(level);
+            return false;
+        }
+        statistics.accepted.add(level);
+        return true;
+    }
+}// namespace
+
 // Meyer's Singleton — C++11 保证线程安全
 
 std::string LogPrivate::m_configFilePath = "./log_config.yaml";
-bool LogPrivate::m_traceShowLine = false;
-bool LogPrivate::m_debugShowLine = false;
-bool LogPrivate::m_infoShowLine = false;
-bool LogPrivate::m_warnShowLine = true;
-bool LogPrivate::m_errorShowLine = true;
-bool LogPrivate::m_criticalShowLine = true;
 
 std::unordered_map<std::string, std::shared_ptr<spdlog::sinks::sink> > LogPrivate::m_callbackSinks;
 
 ID8Generator LogPrivate::m_id8Generator;
 
+std::mutex LogPrivate::m_controlMutex;
 
-// 创建一个回调sink类
-// 不使用spdlog原生call_back_sink：只能取得日志原始内容，无法获取格式化内容
-class callback_sink : public spdlog::sinks::base_sink<std::mutex>
-{
-    public:
-        using callback_t = std::function<void(const LogMsg&)>;
+std::mutex LogPrivate::m_watcherMutex;
 
-        explicit callback_sink(callback_t cb)
-            : callback_(std::move(cb)) {}
 
-    protected:
-        void sink_it_(const spdlog::details::log_msg& msg) override
+void LogPrivate::setConfigPath(const std::string& configFilePath, bool isDeleteOldConfig)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        std::string oldConfigPath = m_configFilePath;
+        try
         {
-            // 格式化消息
-            spdlog::memory_buf_t formatted;
-            this->formatter_->format(msg, formatted);
-            // 调用回调，传递格式化后的字符串
-            if (callback_)
+            getInstance().loadConfigFile(configFilePath);
+            if (getInstance().getLogger()->level() == spdlog::level::off) // 日志级别设置失败，为off
             {
-                LogMsg logMsg;
-                logMsg.fileName = msg.source.filename ? std::string(msg.source.filename) : "";
-                logMsg.codeLine = std::to_string(msg.source.line);
-                logMsg.funcName = msg.source.funcname ? std::string(msg.source.funcname) : "";
-                logMsg.threadId = std::to_string(msg.thread_id);
-                logMsg.msg = std::string(msg.payload.begin(), msg.payload.end());
-                logMsg.msgFormatted = fmt::to_string(formatted);
-                logMsg.level = static_cast<LogLevel>(msg.level);
-
-                callback_(logMsg);
+                std::cout << "[LogPrivate] 日志级别为off" << std::endl;
             }
-        }
-
-        void flush_() override // 此方法必须override
+        } catch (const spdlog::spdlog_ex& ex) // 捕获读取配置文件过程中遇到的异常
         {
-            // 可选实现
+            std::cout << "[LogPrivate] Log initialization error: " << ex.what() << std::endl;
+            if (std::filesystem::exists(configFilePath) && getInstance().m_logger)
+            {
+                // 配置文件存在但有误：不用默认配置替换正在工作的配置
+                std::cout << "[LogPrivate] 保留当前日志配置，配置文件路径：" << std::filesystem::absolute(m_configFilePath) << std::endl;
+            }
+            else
+            {
+                getInstance().loadDefaultConfig(configFilePath); // 采用默认配置
+            }
         }
-
-    private:
-        callback_t callback_;
-};
-
-
-void LogPrivate::setConfigPath(const std::string& configFilePath, bool isDeleteOldConfig)
-{
-    std::string oldConfigPath = m_configFilePath;
-    try
-    {
-        getInstance().loadConfigFile(configFilePath);
-        if (getInstance().getLogger()->level() == spdlog::level::off) // 日志级别设置失败，为off
+        if (isDeleteOldConfig)
         {
-            std::cout << "[LogPrivate] 日志级别为off" << std::endl;
+            getInstance().deleteOldConfig(oldConfigPath);
         }
-    } catch (const spdlog::spdlog_ex& ex) // 捕获读取配置文件过程中遇到的异常
-    {
-        std::cout << "[LogPrivate] Log initialization error: " << ex.what() << std::endl;
-        getInstance().loadDefaultConfig(configFilePath); // 采用默认配置
-    }
-    if (isDeleteOldConfig)
-    {
-        getInstance().deleteOldConfig(oldConfigPath);
     }
+    getInstance().updateConfigWatcher();
 }
 
 void LogPrivate::trace(const char* fileName, int fileLine, const char* function,
                        const std::initializer_list<std::any>& msgList)
 {
-    logImpl(fileName, fileLine, function, msgList, m_traceShowLine, spdlog::level::trace);
+    logImpl(fileName, fileLine, function, msgList, spdlog::level::trace);
 }
 
 void LogPrivate::debug(const char* fileName, int fileLine, const char* function,
                        const std::initializer_list<std::any>& msgList)
 {
-    logImpl(fileName, fileLine, function, msgList, m_debugShowLine, spdlog::level::debug);
+    logImpl(fileName, fileLine, function, msgList, spdlog::level::debug);
 }
 
 void LogPrivate::info(const char* fileName, int fileLine, const char* function,
                       const std::initializer_list<std::any>& msgList)
 {
-    logImpl(fileName, fileLine, function, msgList, m_infoShowLine, spdlog::level::info);
+    logImpl(fileName, fileLine, function, msgList, spdlog::level::info);
 }
 
 void LogPrivate::warn(const char* fileName, int fileLine, const char* function,
                       const std::initializer_list<std::any>& msgList)
 {
-    logImpl(fileName, fileLine, function, msgList, m_warnShowLine, spdlog::level::warn);
+    logImpl(fileName, fileLine, function, msgList, spdlog::level::warn);
 }
 
 void LogPrivate::error(const char* fileName, int fileLine, const char* function,
                        const std::initializer_list<std::any>& msgList)
 {
-    logImpl(fileName, fileLine, function, msgList, m_errorShowLine, spdlog::level::err);
+    logImpl(fileName, fileLine, function, msgList, spdlog::level::err);
 }
 
 void LogPrivate::critical(const char* fileName, int fileLine, const char* function,
                           const std::initializer_list<std::any>& msgList)
 {
-    logImpl(fileName, fileLine, function, msgList, m_criticalShowLine, spdlog::level::critical);
+    logImpl(fileName, fileLine, function, msgList, spdlog::level::critical);
+}
+
+void LogPrivate::logText(LogLevel level, const char* fileName, int fileLine, const char* function,
+                         std::string_view msg, std::size_t msgCount)
+{
+    logImpl(fileName, fileLine, function, msg, msgCount, static_cast<spdlog::level::level_enum>(level));
+}
+
+void LogPrivate::logRecord(LogLevel level, const char* fileName, int fileLine, const char* function,
+                           char* record, std::size_t size)
+{
+    EpochGuard guard;
+    const ActiveLogger* active = getInstance().activeLogger();
+    if (!active)
+        return;
+    if (!active->deferredSink) // 配置已切换为非延迟模式（重载期间的竞态），就地解码后按文本输出
+    {
+        const LoggerUtil::LogRecordReader reader(std::string_view(record, size));
+        LoggerUtil::ScratchBuffer buffer;
+        reader.appendText(buffer.str(), Logger::m_floatPrecision.load(std::memory_order_relaxed));
+        logText(level, fileName, fileLine, function, buffer.view(), reader.argCount());
+        return;
+    }
+    const auto spdlogLevel = static_cast<spdlog::level::level_enum>(level);
+    if (!admit(*active->logger, spdlogLevel))
+        return;
+    LoggerUtil::LogRecordReader::setFlags(record, active->showsLine(spdlogLevel) ? LoggerUtil::LogRecordWriter::kFlagShowLine : 0);
+    // 位置信息随 source_loc 进入队列（仅指针拷贝），由 deferred_format_sink 在 worker 上拼接
+    active->logger->log(spdlog::source_loc{fileName, fileLine, function}, spdlogLevel,
+                        spdlog::string_view_t(record, size));
+}
+
+void LogPrivate::logText(const LogSite& site, std::string_view msg, std::size_t msgCount)
+{
+    auto& instance = getInstance();
+    const auto* entry = instance.m_siteRegistry.acquire(site);
+    if (!entry) // 注册表已满，退回逐条格式化
+    {
+        logText(site.level, site.file, site.line, site.function, msg, msgCount);
+        return;
+    }
+
+    const auto level = static_cast<spdlog::level::level_enum>(site.level);
+    const spdlog::source_loc source{site.file, site.line, site.function};
+    std::string_view hint;
+    if (msg.empty() && msgCount == 1)
+    {
+        hint = " 日志内容为空";
+    }
+    else if (msg.empty() && msgCount > 1)
+    {
+        hint = " 日志打印失败，数据类型转换错误";
+    }
+
+    EpochGuard guard;
+    const ActiveLogger* active = instance.activeLogger();
+    if (!active)
+        return;
+    spdlog::logger* logger = active->logger.get();
+    if (!admit(*logger, level))
+        return;
+    if (hint.empty() && !active->showsLine(level))
+    {
+        logger->log(source, level, spdlog::string_view_t(msg.data(), msg.size()));
+        return;
+    }
+    // 前缀在注册时已拼好，这里只做两次追加，不再经过 fmt 格式化
+    spdlog::memory_buf_t buffer;
+    const std::string_view text = hint.empty() ? msg : hint;
+    buffer.append(entry->prefix.data(), entry->prefix.data() + entry->prefix.size());
+    buffer.append(text.data(), text.data() + text.size());
+    logger->log(source, level, spdlog::string_view_t(buffer.data(), buffer.size()));
+}
+
+void LogPrivate::logRecord(const LogSite& site, char* record, std::size_t size)
+{
+    getInstance().m_siteRegistry.acquire(site);
+    logRecord(site.level, site.file, site.line, site.function, record, size);
+}
+
+std::uint32_t LogPrivate::logSiteCount()
+{
+    return getInstance().m_siteRegistry.size();
+}
+
+const LogSite* LogPrivate::getLogSite(std::uint32_t id)
+{
+    const auto* entry = getInstance().m_siteRegistry.find(id);
+    return entry ? entry->site : nullptr;
 }
 
 void LogPrivate::logImpl(const char* fileName, int fileLine, const char* function,
                          const std::initializer_list<std::any>& msgList,
-                         bool showLine, spdlog::level::level_enum level)
+                         spdlog::level::level_enum level)
 {
-    std::string msg = linkString(fileName, fileLine, function, msgList);
-    auto logger = getInstance().getLogger();
+    if (!Logger::shouldLog(static_cast<LogLevel>(level))) // 直接调用 Logger::info 等接口时同样先过滤，避免无谓的拼接
+    {
+        LogStatistics::instance().filtered.add(level);
+        return;
+    }
+    // 各参数就地追加到线程局部缓冲，再以 string_view 交给 spdlog，稳态下不分配内存
+    LoggerUtil::ScratchBuffer buffer;
+    linkString(fileName, fileLine, function, msgList, buffer.str());
+    logImpl(fileName, fileLine, function, buffer.view(), msgList.size(), level);
+}
+
+void LogPrivate::logImpl(const char* fileName, int fileLine, const char* function,
+                         std::string_view msg, std::size_t msgCount,
+                         spdlog::level::level_enum level)
+{
+    EpochGuard guard;
+    const ActiveLogger* active = getInstance().activeLogger();
+    if (!active)
+        return;
+    spdlog::logger* logger = active->logger.get();
+    if (!admit(*logger, level))
+        return;
 
-    if (msgList.size() == 1 && msg.empty())
+    if (msgCount == 1 && msg.empty())
     {
         logger->log(level, "[{}:{}][{}] 日志内容为空", fileName, fileLine, function);
         return;
     }
-    if (msgList.size() > 1 && msg.empty())
+    if (msgCount > 1 && msg.empty())
     {
         logger->log(level, "[{}:{}][{}] 日志打印失败，数据类型转换错误", fileName, fileLine, function);
         return;
     }
-    if (!showLine)
+    if (!active->showsLine(level))
     {
-        logger->log(level, "{}", msg);
+        logger->log(spdlog::source_loc{}, level, spdlog::string_view_t(msg.data(), msg.size())); // 直接透传，不经过 fmt 格式化
         return;
     }
     logger->log(level, "[{}:{}][{}]{}", fileName, fileLine, function, msg);
@@ -221,6 +336,10 @@ void LogPrivate::logImpl(const char* fileName, int fileLine, const char* functio
 
 void LogPrivate::setStreamOutPut(std::ostringstream& stream, bool flush, LogLevel level)
 {
+    std::unique_lock<std::mutex> lock(m_controlMutex);
+    auto runtimeSinks = getInstance().m_runtimeSinks;
+    if (!runtimeSinks)
+        return;
     auto streamSink = std::make_shared<spdlog::sinks::ostream_sink_mt>(stream, flush);
     spdlog::level::level_enum spdlogLevel = spdlog::level::trace;
     switch (level)
@@ -248,35 +367,76 @@ void LogPrivate::setStreamOutPut(std::ostringstream& stream, bool flush, LogLeve
     }
 
     streamSink->set_level(spdlogLevel);
-    getInstance().getLogger()->sinks().push_back(streamSink);
+    getInstance().attachSink(streamSink);
+    lock.unlock();
+    runtimeSinks->reclaim();
 }
 
 
-std::string LogPrivate::addCallBackSink(const std::function<void(const LogMsg& logMsg)>& logCallBack, LogLevel level)
+std::string LogPrivate::addCallBackSink(const std::function<void(const LogMsg& logMsg)>& logCallBack, LogLevel level,
+                                       const CallbackOptions& options)
 {
-    auto logger = getInstance().getLogger();
-    if (!logger)
-        return {};
-
-    auto sinkId = m_id8Generator();
+    // 旧接口由视图按需构造 LogMsg；同一回调总是串行调用（同步时在 sink 锁内，异步时在分发线程上），可复用同一个 LogMsg
+    return addCallBackSink([logCallBack, logMsg = LogMsg{}](const LogMsgView& view) mutable {
+        view.toLogMsg(logMsg);
+        logCallBack(logMsg);
+    }, level, options);
+}
 
-    // 如果相同ID的sink已经存在，则先删除旧的
-    auto it = m_callbackSinks.find(sinkId);
-    if (it != m_callbackSinks.end())
+std::string LogPrivate::addCallBackSink(const std::function<void(const LogMsgView& logMsg)>& logCallBack, LogLevel level,
+                                       const CallbackOptions& options)
+{
+    std::shared_ptr<spdlog::sinks::sink> cbSink;
+    if (options.mode == CallbackMode::Async)
     {
-        logger->sinks().erase(std::remove(logger->sinks().begin(), logger->sinks().end(), it->second),
-                              logger->sinks().end());
-        m_callbackSinks.erase(it);
-        std::cout << "[LogPrivate] 覆盖原有回调 sink: " << sinkId << std::endl;
+        cbSink = std::make_shared<CustomSink::async_callback_sink>(logCallBack, std::max<std::size_t>(options.queueSize, 2),
+                                                                   options.overflow);
     }
+    else
+    {
+        cbSink = std::make_shared<CustomSink::callback_sink>(logCallBack);
+    }
+    return registerCallBackSink(cbSink, level);
+}
 
-    auto cbSink = std::make_shared<callback_sink>([logCallBack](const LogMsg& logMsg) {
-        logCallBack(logMsg);
-    });
+std::string LogPrivate::addBatchCallBackSink(const std::function<void(const LogMsgBatch& batch)>& logCallBack, LogLevel level,
+                                            std::size_t maxBatch, std::chrono::milliseconds maxDelay)
+{
+    maxBatch = std::max<std::size_t>(maxBatch, 1);
+    auto cbSink = std::make_shared<CustomSink::batch_callback_sink>(
+        logCallBack, maxBatch, std::max(maxDelay, std::chrono::milliseconds(0)), std::max<std::size_t>(maxBatch * 8, 1024));
+    return registerCallBackSink(cbSink, level);
+}
+
+std::string LogPrivate::registerCallBackSink(const std::shared_ptr<spdlog::sinks::sink>& sink, LogLevel level)
+{
+    std::shared_ptr<CustomSink::cow_dist_sink> runtimeSinks;
+    std::string sinkId;
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        runtimeSinks = getInstance().m_runtimeSinks;
+        if (!runtimeSinks)
+            return {};
 
-    cbSink->set_level(static_cast<spdlog::level::level_enum>(level));
-    logger->sinks().push_back(cbSink);
-    m_callbackSinks[sinkId] = cbSink;
+        sinkId = m_id8Generator();
+
+        // 如果相同ID的sink已经存在，则先删除旧的
+        auto it = m_callbackSinks.find(sinkId);
+        if (it != m_callbackSinks.end())
+        {
+            getInstance().detachSink(it->second);
+            m_callbackSinks.erase(it);
+            std::cout << "[LogPrivate] 覆盖原有回调 sink: " << sinkId << std::endl;
+        }
+
+        sink->set_level(static_cast<spdlog::level::level_enum>(level));
+        if (auto counted = std::dynamic_pointer_cast<CustomSink::counted_sink>(sink))
+            counted->set_stats_label("callback:" + sinkId);
+        getInstance().attachSink(sink);
+        m_callbackSinks[sinkId] = sink;
+    }
+    // 释放控制锁后再等待读者离开旧列表，避免与在回调中增删回调的线程互相等待
+    runtimeSinks->reclaim();
 
     std::cout << "[LogPrivate] 添加回调 sink: " << sinkId << std::endl;
 
@@ -285,28 +445,150 @@ std::string LogPrivate::addCallBackSink(const std::function<void(const LogMsg& l
 
 void LogPrivate::removeCallBackSink(const std::string& sinkId)
 {
-    auto logger = getInstance().getLogger();
-    if (!logger)
-        return;
-
-    auto it = m_callbackSinks.find(sinkId);
-    if (it != m_callbackSinks.end())
+    std::shared_ptr<CustomSink::cow_dist_sink> runtimeSinks;
     {
-        logger->sinks().erase(std::remove(logger->sinks().begin(), logger->sinks().end(), it->second),
-                              logger->sinks().end());
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        runtimeSinks = getInstance().m_runtimeSinks;
+        if (!runtimeSinks)
+            return;
+
+        auto it = m_callbackSinks.find(sinkId);
+        if (it == m_callbackSinks.end())
+        {
+            std::cout << "[LogPrivate] 未找到回调 sink: " << sinkId << std::endl;
+            return;
+        }
+        getInstance().detachSink(it->second);
         m_callbackSinks.erase(it);
+    }
+    // 返回后回调不会再被调用（在回调自身中移除时除外，此时其他线程可能仍在执行该回调）
+    runtimeSinks->reclaim();
 
-        std::cout << "[LogPrivate] 移除回调 sink: " << sinkId << std::endl;
+    std::cout << "[LogPrivate] 移除回调 sink: " << sinkId << std::endl;
+}
+
+AsyncStats LogPrivate::asyncStats()
+{
+    auto& instance = getInstance();
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    AsyncStats stats;
+    if (auto perThread = std::dynamic_pointer_cast<CustomSink::per_thread_async_logger>(instance.m_logger)) {
+        stats.enabled = true;
+        stats.perThreadQueue = true;
+        stats.queueCapacity = perThread->ring_capacity();
+        stats.producerQueues = perThread->ring_count();
+        stats.queueDepth = perThread->queue_depth();
+        stats.discardCount = perThread->discard_count();
+        stats.batchCount = perThread->batch_count();
+        return stats;
     }
-    else
+    const auto& threadPool = instance.m_threadPool;
+    if (!threadPool)
+        return stats;
+    stats.enabled = true;
+    stats.queueCapacity = instance.m_asyncQueueCapacity;
+    stats.queueDepth = threadPool->queue_size();
+    stats.overrunCount = threadPool->overrun_counter();
+    stats.discardCount = threadPool->discard_counter();
+    return stats;
+}
+
+std::vector<AsyncSinkStats> LogPrivate::asyncSinkStats()
+{
+    auto& instance = getInstance();
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    std::vector<AsyncSinkStats> result;
+    result.reserve(instance.m_asyncSinks.size());
+    for (const auto& sink: instance.m_asyncSinks)
     {
-        std::cout << "[LogPrivate] 未找到回调 sink: " << sinkId << std::endl;
+        using std::chrono::duration_cast;
+        using std::chrono::microseconds;
+        AsyncSinkStats stats;
+        stats.sink = sink->label();
+        stats.pool = sink->pool_name();
+        stats.queueCapacity = sink->queue_capacity();
+        stats.queueDepth = sink->queue_depth();
+        stats.overrunCount = sink->overrun_count();
+        stats.discardCount = sink->discard_count();
+        stats.enqueued = sink->enqueued();
+        stats.written = sink->meter().written();
+        stats.stallTotal = duration_cast<microseconds>(sink->meter().stall_total());
+        stats.stallMax = duration_cast<microseconds>(sink->meter().stall_max());
+        stats.currentStall = duration_cast<microseconds>(sink->meter().current_stall());
+        result.push_back(std::move(stats));
     }
+    return result;
+}
+
+ConfigReloadStats LogPrivate::configReloadStats()
+{
+    auto& instance = getInstance();
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    ConfigReloadStats stats = instance.m_reloadStats;
+    stats.watching = instance.m_configWatcher.running();
+    return stats;
+}
+
+LoggerStats LogPrivate::getStats()
+{
+    EpochGuard guard;
+    const ActiveLogger* active = getInstance().activeLogger();
+    if (active && active->stats)
+        return active->stats->collect();
+    return StatsScope{}.collect(); // 日志系统已关闭：只有进程级的按级别计数
+}
+
+std::uint64_t LogPrivate::callBackDropCount(const std::string& sinkId)
+{
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    auto it = m_callbackSinks.find(sinkId);
+    if (it == m_callbackSinks.end())
+        return 0;
+    auto asyncSink = std::dynamic_pointer_cast<CustomSink::queued_sink>(it->second);
+    return asyncSink ? asyncSink->dropped() : 0;
 }
 
 void LogPrivate::shutdown()
 {
-    spdlog::shutdown();
+    auto& instance = getInstance();
+    // 旧管线先移出到局部变量，释放 m_controlMutex 后再排空、析构：
+    // 异步线程池排空时仍会执行回调，回调中调用 addCallBack / asyncStats 等接口需要该锁
+    std::shared_ptr<StatsScope> stats;
+    std::shared_ptr<spdlog::logger> logger;
+    std::shared_ptr<CustomSink::deferred_format_sink> deferredSink;
+    std::shared_ptr<CustomSink::cow_dist_sink> runtimeSinks;
+    std::shared_ptr<spdlog::details::thread_pool> threadPool;
+    std::vector<std::shared_ptr<CustomSink::async_sink>> asyncSinks;
+    std::unordered_map<std::string, std::shared_ptr<spdlog::sinks::sink>> callbackSinks;
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        instance.unpublishLogger();
+        stats.swap(instance.m_stats);
+        logger.swap(instance.m_logger);
+        deferredSink.swap(instance.m_deferredSink);
+        runtimeSinks.swap(instance.m_runtimeSinks);
+        threadPool.swap(instance.m_threadPool);
+        asyncSinks.swap(instance.m_asyncSinks);
+        callbackSinks.swap(m_callbackSinks);
+        instance.m_watchOptions = WatchOptions{};
+        Logger::m_deferredFormat.store(false, std::memory_order_relaxed);
+        Logger::m_minLevel.store(static_cast<int>(spdlog::level::off), std::memory_order_relaxed);
+        spdlog::shutdown();
+    }
+
+    // 等待后台释放全部旧管线（正在打日志的线程离开后释放，异步线程池在此排空）
+    if (!instance.m_retireQueue.drain())
+    {
+        std::cout << "[LogPrivate] 在日志回调中调用 shutdown，旧日志管线将在后台释放" << std::endl;
+    }
+    stats.reset(); // 先于 logger 释放：定期输出线程的最后一次输出仍会访问 logger 的队列
+    logger.reset();
+    deferredSink.reset();
+    runtimeSinks.reset();
+    threadPool.reset();
+    asyncSinks.clear();
+    callbackSinks.clear(); // 异步回调 sink 析构时等待分发线程执行完剩余回调
+    instance.updateConfigWatcher();
 }
 
 LogPrivate::LogPrivate()
@@ -330,6 +612,15 @@ LogPrivate::LogPrivate()
         std::cout << "[LogPrivate] Log initialization error: " << ex.what() << std::endl;
         this->loadDefaultConfig(m_configFilePath); // 采用默认配置
     }
+    // 构造可能发生在持有 m_controlMutex 的调用中（首次 getInstance），此时尚无其他线程能访问本对象，直接按加载结果启动监视
+    std::lock_guard<std::mutex> watcherLock(m_watcherMutex);
+    this->applyWatchOptions(m_configFilePath, m_watchOptions);
+}
+
+LogPrivate::~LogPrivate()
+{
+    m_configWatcher.stop();
+    unpublishLogger();// 随后 m_retireQueue 析构时释放
 }
 
 LogPrivate& LogPrivate::getInstance()
@@ -343,9 +634,117 @@ std::shared_ptr<spdlog::logger> LogPrivate::getLogger()
     return m_logger;
 }
 
-void LogPrivate::loadConfigFile(const std::string& configFilePath)
+const LogPrivate::ActiveLogger* LogPrivate::activeLogger() const
+{
+    return m_active.load(std::memory_order_acquire);
+}
+
+void LogPrivate::publishLogger()
+{
+    auto active = std::make_unique<ActiveLogger>();
+    active->logger = this->m_logger;
+    active->deferredSink = this->m_deferredSink;
+    active->threadPool = this->m_threadPool;
+    active->stats = this->m_stats;
+    active->showLine = this->m_showLine;
+    retireLogger(m_active.exchange(active.release(), std::memory_order_acq_rel));
+}
+
+void LogPrivate::unpublishLogger()
+{
+    retireLogger(m_active.exchange(nullptr, std::memory_order_acq_rel));
+}
+
+void LogPrivate::retireLogger(ActiveLogger* old)
+{
+    // 后台线程等待读者离开后释放：同步 logger 直接释放，异步 logger 的旧线程池排空队列后退出
+    m_retireQueue.retire(std::shared_ptr<ActiveLogger>(old));
+}
+
+void LogPrivate::attachSink(const std::shared_ptr<spdlog::sinks::sink>& sink)
+{
+    this->m_runtimeSinks->add_sink(sink);
+}
+
+void LogPrivate::detachSink(const std::shared_ptr<spdlog::sinks::sink>& sink)
+{
+    this->m_runtimeSinks->remove_sink(sink);
+}
+
+void LogPrivate::updateConfigWatcher()
+{
+    std::lock_guard<std::mutex> watcherLock(m_watcherMutex);
+    if (m_configWatcher.onWatcherThread())
+        return;// 监视线程自身在 reloadWatchedConfig 中调整
+
+    std::string path;
+    WatchOptions options;
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        if (m_logger)
+        {
+            path = m_configFilePath;
+            options = m_watchOptions;
+        }
+    }
+    applyWatchOptions(path, options);
+}
+
+void LogPrivate::applyWatchOptions(const std::string& path, const WatchOptions& options)
+{
+    if (!options.enabled)
+    {
+        m_configWatcher.stop();
+        return;
+    }
+    const auto watched = std::filesystem::absolute(path);
+    if (m_configWatcher.running() && m_configWatcher.path() == watched)
+    {
+        m_configWatcher.setDebounce(options.debounce);
+        m_configWatcher.setPollInterval(options.pollInterval);
+        return;
+    }
+    m_configWatcher.start(path, options.debounce, options.pollInterval,
+                          [this, watched](ConfigWatcher::clock::time_point detectedAt) {
+                              return reloadWatchedConfig(watched, detectedAt);
+                          });
+    std::cout << "[LogPrivate] 开始监视日志配置文件（" << (m_configWatcher.usingInotify() ? "inotify" : "轮询")
+              << "）：" << watched << std::endl;
+}
+
+bool LogPrivate::reloadWatchedConfig(const std::filesystem::path& path, ConfigWatcher::clock::time_point detectedAt)
+{
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    // 期间配置已切换到其他文件、关闭了监视或日志系统已关闭：停止本次监视，由切换方重新安排
+    if (!m_logger || !m_watchOptions.enabled || std::filesystem::absolute(m_configFilePath) != path)
+        return false;
+
+    try
+    {
+        // 新配置在旁路构建并校验，失败时不影响当前配置，也不改写配置文件；回调与流输出沿用到新配置
+        loadConfigFile(m_configFilePath, true);
+        const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(ConfigWatcher::clock::now() - detectedAt);
+        ++m_reloadStats.reloads;
+        m_reloadStats.lastLatency = latency;
+        m_reloadStats.maxLatency = std::max(m_reloadStats.maxLatency, latency);
+        std::cout << "[LogPrivate] 日志配置文件已变化，重新加载完成，耗时 " << latency.count() << "us" << std::endl;
+    } catch (const std::exception& ex)
+    {
+        ++m_reloadStats.failures;
+        m_reloadStats.lastError = ex.what();
+        std::cout << "[LogPrivate] 日志配置文件重新加载失败，保留当前配置：" << ex.what() << std::endl;
+    }
+    m_configWatcher.setDebounce(m_watchOptions.debounce);
+    m_configWatcher.setPollInterval(m_watchOptions.pollInterval);
+    return m_watchOptions.enabled;
+}
+
+void LogPrivate::loadConfigFile(const std::string& configFilePath, bool keepRuntimeSinks)
 {
-    this->m_logger.reset(); //重新设置日志
+    // 新管线全部构建在局部变量中，成功后才整体替换并发布；中途抛出异常时当前管线不受影响
+    std::shared_ptr<spdlog::logger> logger;
+    std::shared_ptr<CustomSink::deferred_format_sink> deferredSink;
+    std::shared_ptr<spdlog::details::thread_pool> threadPool;
 
     YamlTool::YamlNode rootNode;
     if (!YamlTool::YamlTool::loadFile(rootNode, configFilePath))
@@ -365,7 +764,6 @@ void LogPrivate::loadConfigFile(const std::string& configFilePath)
 
     // deleteOldConfig(m_configFilePath);
 
-    m_configFilePath = configFilePath;
     // 获取logger名称
     auto loggerName = YamlTool::YamlTool::getDef<std::string>(loggerNode, "name", "default-logger");
 
@@ -387,33 +785,174 @@ void LogPrivate::loadConfigFile(const std::string& configFilePath)
 
     // 获取异步日志配置（防御性读取，兼容旧版配置文件缺失这些 key 的情况）
     bool asyncEnabled = false;
+    bool asyncDeferredFormat = false;
     int asyncQueueSize = 8192;
     int asyncThreadCount = 1;
     try {
         auto asyncStr = YamlTool::YamlTool::getDef<std::string>(loggerNode, "async", "false");
         asyncEnabled = (asyncStr == "true" || asyncStr == "1");
     } catch (...) {}
+    try {
+        auto deferredStr = YamlTool::YamlTool::getDef<std::string>(loggerNode, "async_deferred_format", "false");
+        asyncDeferredFormat = asyncEnabled && (deferredStr == "true" || deferredStr == "1"); // 仅异步模式下有效
+    } catch (...) {}
     try {
         asyncQueueSize = std::stoi(YamlTool::YamlTool::getDef<std::string>(loggerNode, "async_queue_size", "8192"));
     } catch (...) {}
     try {
         asyncThreadCount = std::stoi(YamlTool::YamlTool::getDef<std::string>(loggerNode, "async_thread_count", "1"));
     } catch (...) {}
+    // 队列满时的处理：block 阻塞调用线程（默认），overrun_oldest 覆盖最旧的日志，discard_new 丢弃新日志
+    spdlog::async_overflow_policy asyncOverflowPolicy = spdlog::async_overflow_policy::block;
+    try {
+        asyncOverflowPolicy = parseOverflowPolicy(
+                YamlTool::YamlTool::getDef<std::string>(loggerNode, "async_overflow_policy", "block"),
+                spdlog::async_overflow_policy::block);
+    } catch (...) {}
+    // 异步队列：shared 为 spdlog 线程池的共享队列（默认），per_thread 为每个打日志的线程一条无锁队列
+    bool perThreadQueue = false;
+    try {
+        auto queueStr = YamlTool::YamlTool::getDef<std::string>(loggerNode, "async_queue", "shared");
+        if (queueStr == "per_thread") {
+            perThreadQueue = true;
+        } else if (queueStr != "shared") {
+            std::cout << "[LogPrivate] 未知的 async_queue: " << queueStr << "，使用 shared" << std::endl;
+        }
+    } catch (...) {}
+    // per_thread 队列的 worker 每批最多写出的条数
+    int asyncBatchSize = 256;
+    try {
+        asyncBatchSize = std::stoi(YamlTool::YamlTool::getDef<std::string>(loggerNode, "async_batch_size", "256"));
+    } catch (...) {}
+    // 异步线程的名称、CPU 亲和性与调度优先级，由线程池的 on_thread_start 在每个线程上应用
+    ThreadTuning asyncTuning;
+    try {
+        asyncTuning.name = YamlTool::YamlTool::getDef<std::string>(loggerNode, "async_thread_name", "");
+    } catch (...) {}
+    try {
+        auto cpuStr = YamlTool::YamlTool::getDef<std::string>(loggerNode, "async_cpu_affinity", "");
+        if (!ThreadTuning::parseCpuList(cpuStr, asyncTuning.cpus)) {
+            std::cout << "[LogPrivate] async_cpu_affinity 格式错误: " << cpuStr << std::endl;
+        }
+    } catch (...) {}
+    try {
+        auto niceStr = YamlTool::YamlTool::getDef<std::string>(loggerNode, "async_nice", "");
+        if (!niceStr.empty()) {
+            asyncTuning.nice = std::clamp(std::stoi(niceStr), -20, 19);
+            asyncTuning.setNice = true;
+        }
+    } catch (...) {}
+    try {
+        auto idleStr = YamlTool::YamlTool::getDef<std::string>(loggerNode, "async_sched_idle", "false");
+        asyncTuning.schedIdle = (idleStr == "true" || idleStr == "1");
+    } catch (...) {}
+
+    // 浮点数输出的小数位数，-1（默认）为最短往返表示
+    int floatPrecision = LoggerUtil::kShortestFloat;
+    try {
+        floatPrecision = std::stoi(YamlTool::YamlTool::getDef<std::string>(loggerNode, "float_precision", "-1"));
+    } catch (...) {}
+    floatPrecision = std::clamp(floatPrecision, LoggerUtil::kShortestFloat, LoggerUtil::kMaxFloatPrecision);
+
+    // 配置文件监视：watch 为 true 时修改配置文件后自动重新加载
+    WatchOptions watch;
+    try {
+        auto watchStr = YamlTool::YamlTool::getDef<std::string>(loggerNode, "watch", "false");
+        watch.enabled = (watchStr == "true" || watchStr == "1");
+    } catch (...) {}
+    try {
+        watch.debounce = std::chrono::milliseconds(
+                std::stoi(YamlTool::YamlTool::getDef<std::string>(loggerNode, "watch_debounce_ms", "200")));
+    } catch (...) {}
+    try {
+        watch.pollInterval = std::chrono::milliseconds(
+                std::stoi(YamlTool::YamlTool::getDef<std::string>(loggerNode, "watch_poll_ms", "1000")));
+    } catch (...) {}
+
+    // 日志统计的定期输出（stats 节点，可选）：interval_ms 为 0 或未配置输出目标时不输出
+    StatsReportOptions statsReport;
+    YamlTool::YamlNode statsNode = YamlTool::YamlTool::getNode(logConfigNode, "stats");
+    if (statsNode.isDefined() && !statsNode.isNull())
+    {
+        statsReport.interval = std::chrono::milliseconds(
+                std::max(YamlTool::YamlTool::getDef<int>(statsNode, "interval_ms", 0), 0));
+        statsReport.filePath = YamlTool::YamlTool::getDef<std::string>(statsNode, "file_path", "");
+        statsReport.prometheusFile = YamlTool::YamlTool::getDef<std::string>(statsNode, "prometheus_file", "");
+    }
 
     // 获取各级别日志是否按照输出格式输出
+    // 节点缺失时沿用当前配置
+    ShowLineFlags showLine = this->m_showLine;
     YamlTool::YamlNode showCodeLineNode = YamlTool::YamlTool::getNode(logConfigNode, "showCodeLine");
     if (showCodeLineNode.isDefined() && !showCodeLineNode.isNull())
     {
-        m_traceShowLine = YamlTool::YamlTool::getDef<bool>(showCodeLineNode, "trace", false);
-        m_debugShowLine = YamlTool::YamlTool::getDef<bool>(showCodeLineNode, "debug", false);
-        m_infoShowLine = YamlTool::YamlTool::getDef<bool>(showCodeLineNode, "info", false);
-        m_warnShowLine = YamlTool::YamlTool::getDef<bool>(showCodeLineNode, "warn", true);
-        m_errorShowLine = YamlTool::YamlTool::getDef<bool>(showCodeLineNode, "error", true);
-        m_criticalShowLine = YamlTool::YamlTool::getDef<bool>(showCodeLineNode, "critical", true);
+        showLine[spdlog::level::trace] = YamlTool::YamlTool::getDef<bool>(showCodeLineNode, "trace", false);
+        showLine[spdlog::level::debug] = YamlTool::YamlTool::getDef<bool>(showCodeLineNode, "debug", false);
+        showLine[spdlog::level::info] = YamlTool::YamlTool::getDef<bool>(showCodeLineNode, "info", false);
+        showLine[spdlog::level::warn] = YamlTool::YamlTool::getDef<bool>(showCodeLineNode, "warn", true);
+        showLine[spdlog::level::err] = YamlTool::YamlTool::getDef<bool>(showCodeLineNode, "error", true);
+        showLine[spdlog::level::critical] = YamlTool::YamlTool::getDef<bool>(showCodeLineNode, "critical", true);
+    }
+
+    // 具名线程池（thread_pools 节点），供 async: true 的 sink 通过 thread_pool 共用，首次被引用时创建
+    struct NamedPool
+    {
+        int queueSize = 8192;
+        int threadCount = 1;
+        std::shared_ptr<spdlog::details::thread_pool> pool;
+    };
+    std::unordered_map<std::string, NamedPool> namedPools;
+    YamlTool::YamlNode poolsNode = YamlTool::YamlTool::getNode(logConfigNode, "thread_pools");
+    if (poolsNode.isDefined() && !poolsNode.isNull() && poolsNode.isSequence())
+    {
+        for (std::size_t i = 0; i < poolsNode.size(); ++i)
+        {
+            YamlTool::YamlNode poolNode = YamlTool::YamlTool::getSequenceNode(poolsNode, i);
+            auto name = YamlTool::YamlTool::getDef<std::string>(poolNode, "name", "");
+            if (name.empty())
+            {
+                std::cout << "[LogPrivate] thread_pools 中的线程池未设置 name, index: " << i << std::endl;
+                continue;
+            }
+            NamedPool& namedPool = namedPools[name];
+            namedPool.queueSize = std::max(YamlTool::YamlTool::getDef<int>(poolNode, "queue_size", 8192), 1);
+            namedPool.threadCount = std::max(YamlTool::YamlTool::getDef<int>(poolNode, "thread_count", 1), 1);
+        }
     }
+    std::vector<std::shared_ptr<CustomSink::async_sink> > asyncSinks;
 
     YamlTool::YamlNode sinksNode = YamlTool::YamlTool::getNode(logConfigNode, "sinks");
     std::vector<std::shared_ptr<spdlog::sinks::sink> > sinks;
+    // 运行时增删的 sink（回调、流输出）挂在这个固定子 sink 上，logger 自身的 sink 列表构造后不再修改
+    auto runtimeSinks = keepRuntimeSinks && this->m_runtimeSinks ? this->m_runtimeSinks
+                                                                 : std::make_shared<CustomSink::cow_dist_sink>();
+    std::vector<std::shared_ptr<spdlog::sinks::sink> > recordSinks; // 直接接收原始记录的 sink（binary_file_mt）
+    // 本配置的统计范围：stats_sink 挂在 sink 列表末尾，各 sink 在创建时登记
+    auto statsScope = std::make_shared<StatsScope>();
+    statsScope->statsSink = std::make_shared<CustomSink::stats_sink>();
+    statsScope->runtimeSinks = runtimeSinks;
+    // 创建异步 logger：per_thread 队列自带单个 worker 线程，shared 队列使用本配置的线程池
+    auto makeAsyncLogger = [&](const std::string& name, const std::vector<std::shared_ptr<spdlog::sinks::sink> >& frontSinks)
+            -> std::shared_ptr<spdlog::logger> {
+        // 队列探测函数按裸指针访问：统计范围随快照先于 logger / 线程池释放，且发布前 worker 不会收到日志
+        if (perThreadQueue) {
+            auto perThread = std::make_shared<CustomSink::per_thread_async_logger>(
+                    name, frontSinks.begin(), frontSinks.end(), static_cast<std::size_t>(std::max(asyncQueueSize, 2)),
+                    asyncOverflowPolicy, static_cast<std::size_t>(std::max(asyncBatchSize, 1)),
+                    asyncTuning.onThreadStart());
+            statsScope->statsSink->set_queue_probes([raw = perThread.get()] { return raw->queue_depth(); },
+                                                    [raw = perThread.get()] { return raw->discard_count(); },
+                                                    true);
+            return perThread;
+        }
+        threadPool = std::make_shared<spdlog::details::thread_pool>(asyncQueueSize, asyncThreadCount,
+                                                                    asyncTuning.onThreadStart());
+        statsScope->statsSink->set_queue_probes(
+                [pool = threadPool.get()] { return pool->queue_size(); },
+                [pool = threadPool.get()] { return pool->overrun_counter() + pool->discard_counter(); });
+        return std::make_shared<spdlog::async_logger>(name, frontSinks.begin(), frontSinks.end(), threadPool,
+                                                     asyncOverflowPolicy);
+    };
 
     if (!sinksNode.isDefined() || sinksNode.isNull() || !sinksNode.isSequence())
     {
@@ -425,11 +964,18 @@ void LogPrivate::loadConfigFile(const std::string& configFilePath)
         {
             auto consoleSink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>(); // 创建控制台sink
             consoleSink->set_pattern(logPatternStr);
+            statsScope->addSink(SINK_TYPE_STDOUT_COLOR_SINK_MT, consoleSink);
             if (asyncEnabled) {
-                spdlog::init_thread_pool(asyncQueueSize, asyncThreadCount);
-                this->m_logger = std::make_shared<spdlog::async_logger>("console", consoleSink, spdlog::thread_pool());
+                std::vector<std::shared_ptr<spdlog::sinks::sink> > frontSinks{consoleSink, runtimeSinks, statsScope->statsSink};
+                if (asyncDeferredFormat) {
+                    deferredSink = std::make_shared<CustomSink::deferred_format_sink>(
+                        frontSinks, std::vector<std::shared_ptr<spdlog::sinks::sink> >{}, floatPrecision);
+                    frontSinks = {deferredSink};
+                }
+                logger = makeAsyncLogger("console", frontSinks);
             } else {
-                this->m_logger = std::make_shared<spdlog::logger>("console", consoleSink);
+                logger = std::make_shared<spdlog::logger>(
+                    "console", spdlog::sinks_init_list{consoleSink, runtimeSinks, statsScope->statsSink});
             }
             std::cout << "[LogPrivate] LogPrivate not set Sink, used default: console!" << std::endl;
         }
@@ -449,6 +995,8 @@ void LogPrivate::loadConfigFile(const std::string& configFilePath)
                     auto type = YamlTool::YamlTool::getDef<std::string>(sinkNode, "type", "");
                     auto sinkLevel = spdlog::level::from_str(
                         YamlTool::YamlTool::getDef<std::string>(sinkNode, "level", "trace"));
+                    const std::size_t sinkCount = sinks.size();
+                    const std::size_t recordSinkCount = recordSinks.size();
 
                     // 注意，spdlog默认支持两种sink：多线程mt和单线程st，mt虽然性能比st低，但多线程安全，因此默认使用mt，不再使用st
                     if (type == SINK_TYPE_STDOUT_COLOR_SINK_MT) // 控制台sink
@@ -507,7 +1055,8 @@ void LogPrivate::loadConfigFile(const std::string& configFilePath)
 
                         auto truncate = YamlTool::YamlTool::getDef<bool>(sinkNode, "truncate", false);
                         // 是否清空截断，false则下次打开追加写入
-                        auto fileSink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(filePath, truncate);
+                        // 与 basic_file_sink_mt 行为一致，另外支持异步 worker 的批量写入
+                        auto fileSink = std::make_shared<CustomSink::batch_file_sink_mt>(filePath, truncate);
                         fileSink->set_level(sinkLevel);
                         sinks.push_back(fileSink);
                     }
@@ -559,33 +1108,146 @@ void LogPrivate::loadConfigFile(const std::string& configFilePath)
                         fileSink->set_level(sinkLevel);
                         sinks.push_back(fileSink);
                     }
+                    else if (type == SINK_TYPE_BINARY_FILE_MT) // 二进制日志文件sink
+                    {
+                        auto filePath = YamlTool::YamlTool::getDef<std::string>(sinkNode, "file_path", "");
+                        if (filePath.empty())
+                        {
+                            std::cout << "[LogPrivate] file_path is empty, index: " + std::to_string(i);
+                            continue;
+                        }
+
+                        auto truncate = YamlTool::YamlTool::getDef<bool>(sinkNode, "truncate", false);
+                        // 是否清空截断，false则下次打开追加写入新的一段
+                        auto fileSink = std::make_shared<CustomSink::binary_file_mt<std::mutex> >(
+                            filePath, truncate, logPatternStr, floatPrecision);
+                        fileSink->set_level(sinkLevel);
+                        recordSinks.push_back(fileSink);
+                    }
+                    else if (type == SINK_TYPE_NULL) // 黑洞sink，丢弃日志（用于基准测试或临时关闭输出）
+                    {
+                        auto nullSink = std::make_shared<spdlog::sinks::null_sink_mt>();
+                        nullSink->set_level(sinkLevel);
+                        sinks.push_back(nullSink);
+                    }
                     else
                     {
                         std::cout << "[LogPrivate] sink type is not supported now, index: " + std::to_string(i) <<
                                 ", type: " << type << std::endl;
                     }
+
+                    // 统计登记配置的 sink 本身（sink 级异步时在换成外层 sink 之前取得）
+                    const std::string sinkLabel = type + "#" + std::to_string(i);
+                    const auto configuredSink = sinks.size() > sinkCount ? sinks.back() : nullptr;
+                    if (recordSinks.size() > recordSinkCount)
+                    {
+                        statsScope->addSink(sinkLabel, recordSinks.back());
+                    }
+
+                    // sink 级异步：独立队列（或具名线程池）写入，慢 sink 不拖住其他 sink
+                    const auto sinkAsyncStr = YamlTool::YamlTool::getDef<std::string>(sinkNode, "async", "false");
+                    std::shared_ptr<CustomSink::async_sink> asyncSink;
+                    if (sinkAsyncStr == "true" || sinkAsyncStr == "1")
+                    {
+                        if (sinks.size() == sinkCount)
+                        {
+                            std::cout << "[LogPrivate] sink 不支持 async, index: " << i << ", type: " << type << std::endl;
+                            continue;
+                        }
+                        // 未指定时沿用 logger 的 async_overflow_policy
+                        const auto sinkPolicyStr = YamlTool::YamlTool::getDef<std::string>(sinkNode, "async_overflow_policy", "");
+                        const auto sinkPolicy = sinkPolicyStr.empty()
+                                                        ? asyncOverflowPolicy
+                                                        : parseOverflowPolicy(sinkPolicyStr, asyncOverflowPolicy);
+                        auto poolName = YamlTool::YamlTool::getDef<std::string>(sinkNode, "thread_pool", "");
+                        std::shared_ptr<spdlog::details::thread_pool> pool;
+                        std::size_t capacity = 0;
+                        auto namedPool = namedPools.find(poolName);
+                        if (!poolName.empty() && namedPool == namedPools.end())
+                        {
+                            std::cout << "[LogPrivate] 未定义的 thread_pool: " << poolName << "，使用独立队列, index: " << i << std::endl;
+                            poolName.clear();
+                        }
+                        if (!poolName.empty())
+                        {
+                            if (!namedPool->second.pool)
+                            {
+                                namedPool->second.pool = std::make_shared<spdlog::details::thread_pool>(
+                                    namedPool->second.queueSize, namedPool->second.threadCount,
+                                    asyncTuning.onThreadStart(poolName));
+                            }
+                            pool = namedPool->second.pool;
+                            capacity = static_cast<std::size_t>(namedPool->second.queueSize);
+                        }
+                        else
+                        {
+                            const int queueSize = std::max(
+                                YamlTool::YamlTool::getDef<int>(sinkNode, "async_queue_size", 8192), 1);
+                            pool = std::make_shared<spdlog::details::thread_pool>(queueSize, 1, asyncTuning.onThreadStart());
+                            capacity = static_cast<std::size_t>(queueSize);
+                        }
+                        asyncSink = std::make_shared<CustomSink::async_sink>(
+                            sinks.back(), sinkLabel, pool, poolName, capacity, sinkPolicy, flushOn);
+                        sinks.back() = asyncSink;
+                        asyncSinks.push_back(asyncSink);
+                    }
+                    if (configuredSink)
+                    {
+                        statsScope->addSink(sinkLabel, configuredSink, asyncSink);
+                    }
                 }
             }
         }
-        if (asyncEnabled) {
-            spdlog::init_thread_pool(asyncQueueSize, asyncThreadCount);
-            this->m_logger = std::make_shared<spdlog::async_logger>(loggerName, sinks.begin(), sinks.end(), spdlog::thread_pool());
+        sinks.push_back(runtimeSinks);
+        sinks.push_back(statsScope->statsSink);
+        // 二进制 sink 只认原始记录，配置了它就必须走延迟格式化（同步模式下在调用线程上解码给文本 sink）
+        bool deferredFormat = asyncDeferredFormat || !recordSinks.empty();
+        if (deferredFormat) {
+            // 延迟格式化：先由分发 sink 解码记录，再交给各个真正的 sink
+            deferredSink = std::make_shared<CustomSink::deferred_format_sink>(sinks, recordSinks, floatPrecision);
+        }
+        if (asyncEnabled && deferredFormat) {
+            logger = makeAsyncLogger(loggerName, {deferredSink});
+        } else if (asyncEnabled) {
+            logger = makeAsyncLogger(loggerName, sinks);
+        } else if (deferredFormat) {
+            logger = std::make_shared<spdlog::logger>(loggerName, deferredSink);
         } else {
-            this->m_logger = std::make_shared<spdlog::logger>(loggerName);
-            for (const auto& sink: sinks)
-            {
-                this->m_logger->sinks().push_back(sink);
-            }
+            logger = std::make_shared<spdlog::logger>(loggerName, sinks.begin(), sinks.end());
         }
     }
 
 #ifdef DEBUG
-    this->m_logger->set_level(debugLevel);
+    logger->set_level(debugLevel);
 #else//release模式下，提升日志级别，或关闭日志输出
-    this->m_logger->set_level(releaseLevel);
+    logger->set_level(releaseLevel);
 #endif
-    this->m_logger->flush_on(flushOn);
-    this->m_logger->set_pattern(logPatternStr);
+    logger->flush_on(flushOn);
+    logger->set_pattern(logPatternStr);
+
+    if (statsReport.enabled())
+    {
+        // 定期输出线程只读统计范围内的原子计数；统计文件无法打开时抛出异常，当前配置不受影响
+        statsScope->reporter = std::make_unique<StatsReporter>(
+                statsReport, [scope = statsScope.get()] { return scope->collect(); },
+                asyncTuning.onThreadStart("log-stats"));
+    }
+
+    // 整体替换并发布；旧管线交给后台释放（异步线程池排空后退出），打日志的线程不会等待
+    this->m_logger = logger;
+    this->m_deferredSink = deferredSink;
+    this->m_runtimeSinks = runtimeSinks;
+    this->m_threadPool = threadPool;
+    this->m_asyncQueueCapacity = threadPool ? static_cast<std::size_t>(asyncQueueSize) : 0;
+    this->m_asyncSinks = asyncSinks;
+    this->m_stats = statsScope;
+    this->m_showLine = showLine;
+    this->m_watchOptions = watch;
+    m_configFilePath = configFilePath;
+    syncLevelGate();
+    Logger::m_floatPrecision.store(floatPrecision, std::memory_order_relaxed);
+    Logger::m_deferredFormat.store(deferredSink != nullptr, std::memory_order_relaxed);
+    publishLogger();
 
     std::cout << "[LogPrivate] 日志配置文件加载成功，配置文件路径：" << std::filesystem::absolute(configFilePath) << std::endl;
 }
@@ -593,23 +1255,35 @@ void LogPrivate::loadConfigFile(const std::string& configFilePath)
 void LogPrivate::loadDefaultConfig(const std::string& configFilePath)
 {
     // 创建日志及设置名称
-    this->m_logger = std::make_shared<spdlog::logger>("log-default");
+    auto runtimeSinks = std::make_shared<CustomSink::cow_dist_sink>();
+    auto statsScope = std::make_shared<StatsScope>();
+    statsScope->statsSink = std::make_shared<CustomSink::stats_sink>();
+    statsScope->runtimeSinks = runtimeSinks;
+    auto logger = std::make_shared<spdlog::logger>("log-default",
+                                                   spdlog::sinks_init_list{runtimeSinks, statsScope->statsSink});
     // 设置日志级别
 #ifdef MZ_LOG_DEBUG//release模式下，提升日志级别，或关闭日志输出
-    this->m_logger->set_level(spdlog::level::trace);
+    logger->set_level(spdlog::level::trace);
 #else
-    this->m_logger->set_level(spdlog::level::warn);
+    logger->set_level(spdlog::level::warn);
 #endif
     // 设置日志格式
-    this->m_logger->set_pattern("[%Y-%m-%d %H:%M:%S.%e][%n][%^%l%$][thread %t]%v");
-
+    logger->set_pattern("[%Y-%m-%d %H:%M:%S.%e][%n][%^%l%$][thread %t]%v");
+
+    this->m_logger = logger;
+    this->m_deferredSink.reset();
+    this->m_runtimeSinks = runtimeSinks;
+    this->m_threadPool.reset();
+    this->m_asyncQueueCapacity = 0;
+    this->m_asyncSinks.clear();
+    this->m_stats = statsScope;
     // 设置日志输出是否显示行号
-    m_traceShowLine = false;
-    m_debugShowLine = false;
-    m_infoShowLine = false;
-    m_warnShowLine = true;
-    m_errorShowLine = true;
-    m_criticalShowLine = true;
+    this->m_showLine = kDefaultShowLine;
+    this->m_watchOptions = WatchOptions{};
+    syncLevelGate();
+    Logger::m_deferredFormat.store(false, std::memory_order_relaxed);
+    Logger::m_floatPrecision.store(LoggerUtil::kShortestFloat, std::memory_order_relaxed);
+    publishLogger();
 
     //组织配置文件所需的参数并写入配置文件
     std::string loggerName = "default-log";
@@ -619,8 +1293,17 @@ void LogPrivate::loadDefaultConfig(const std::string& configFilePath)
     std::string logPatternStr = "[%Y-%m-%d %H:%M:%S.%e][%n][%^%l%$][thread %t]%v";
 
     std::string asyncEnabled = "false";
+    std::string asyncDeferredFormat = "false";
     std::string asyncQueueSize = "8192";
     std::string asyncThreadCount = "1";
+    std::string asyncOverflowPolicy = "block";
+    std::string asyncQueue = "shared";
+    std::string asyncBatchSize = "256";
+    std::string asyncThreadName = "log-async";
+    std::string asyncCpuAffinity = "";
+    std::string asyncNice = "";
+    std::string asyncSchedIdle = "false";
+    std::string floatPrecision = "-1";
 
     std::string traceShowLine = "false";
     std::string debugShowLine = "false";
@@ -683,8 +1366,17 @@ void LogPrivate::loadDefaultConfig(const std::string& configFilePath)
     YamlTool::YamlTool::setDef<std::string>(loggerNode, "flush_on", flushOn);
     YamlTool::YamlTool::setDef<std::string>(loggerNode, "pattern", logPatternStr);
     YamlTool::YamlTool::setDef<std::string>(loggerNode, "async", asyncEnabled);
+    YamlTool::YamlTool::setDef<std::string>(loggerNode, "async_deferred_format", asyncDeferredFormat);
     YamlTool::YamlTool::setDef<std::string>(loggerNode, "async_queue_size", asyncQueueSize);
     YamlTool::YamlTool::setDef<std::string>(loggerNode, "async_thread_count", asyncThreadCount);
+    YamlTool::YamlTool::setDef<std::string>(loggerNode, "async_overflow_policy", asyncOverflowPolicy);
+    YamlTool::YamlTool::setDef<std::string>(loggerNode, "async_queue", asyncQueue);
+    YamlTool::YamlTool::setDef<std::string>(loggerNode, "async_batch_size", asyncBatchSize);
+    YamlTool::YamlTool::setDef<std::string>(loggerNode, "async_thread_name", asyncThreadName);
+    YamlTool::YamlTool::setDef<std::string>(loggerNode, "async_cpu_affinity", asyncCpuAffinity);
+    YamlTool::YamlTool::setDef<std::string>(loggerNode, "async_nice", asyncNice);
+    YamlTool::YamlTool::setDef<std::string>(loggerNode, "async_sched_idle", asyncSchedIdle);
+    YamlTool::YamlTool::setDef<std::string>(loggerNode, "float_precision", floatPrecision);
 
     YamlTool::YamlTool::setDef<std::string>(showCodeLineNode, "trace", traceShowLine);
     YamlTool::YamlTool::setDef<std::string>(showCodeLineNode, "debug", debugShowLine);
@@ -755,6 +1447,12 @@ void LogPrivate::loadDefaultConfig(const std::string& configFilePath)
 
     YamlTool::YamlTool::addNode(rootNode, "log_config", logConfigNode);
 
+    if (std::filesystem::exists(configFilePath))
+    {
+        // 已有的配置文件可能只是暂时写错，不覆盖，修正后重新调用 setConfigPath 即可
+        std::cout << "[LogPrivate] 日志配置文件无法加载，使用内置默认配置，不覆盖原文件：" << std::filesystem::absolute(configFilePath) << std::endl;
+        return;
+    }
     try
     {
         YamlTool::YamlTool::saveAsFile(rootNode, configFilePath);
@@ -789,6 +1487,12 @@ void LogPrivate::deleteOldConfig(const std::string& configFilePath)
     }
 }
 
+void LogPrivate::syncLevelGate()
+{
+    const int level = this->m_logger ? static_cast<int>(this->m_logger->level()) : static_cast<int>(spdlog::level::trace);
+    Logger::m_minLevel.store(level, std::memory_order_relaxed);
+}
+
 std::string LogPrivate::getItemValue(const std::string& itemValue, const std::string& itemName,
                                      const std::string& defaultValue)
 {
@@ -812,51 +1516,42 @@ bool LogPrivate::checkSinkFilePath(const std::string& sinkType, const std::strin
 }
 
 
-std::string LogPrivate::linkString(const char* fileName, int fileLine, const char* function,
-                                   const std::initializer_list<std::any>& msgList)
+void LogPrivate::linkString(const char* fileName, int fileLine, const char* function,
+                            const std::initializer_list<std::any>& msgList, std::string& out)
 {
-    if (msgList.size() == 0)
-    {
-        return {};
-    }
-
-    std::string linkStr;
-    linkStr.clear();
     for (const auto& msg: msgList)
     {
-        std::string msgStr = anyToString(fileName, fileLine, function, msg);
-        // if (msgStr.empty())
-        // {
-        // 	return {};
-        // }
-        linkStr += msgStr;
+        appendAny(fileName, fileLine, function, msg, out);
     }
-    return linkStr;
 }
 
-std::string LogPrivate::anyToString(const char* fileName, int fileLine, const char* function, const std::any& data)
+void LogPrivate::appendAny(const char* fileName, int fileLine, const char* function, const std::any& data,
+                           std::string& out)
 {
-    if (!data.has_value())
+    if (LoggerUtil::appendAny(out, data, Logger::m_floatPrecision.load(std::memory_order_relaxed)))
     {
-        getInstance().getLogger()->debug("[{}:{}][{}] anyToString: empty std::any", fileName, fileLine, function);
-        return {};
+        return;
     }
 
-    if (data.type() == typeid(std::nullptr_t))
+    EpochGuard guard;
+    const ActiveLogger* active = getInstance().activeLogger();
+    if (!active)
     {
-        getInstance().getLogger()->warn("[{}:{}][{}] anyToString: std::any holds nullptr_t (prefer empty std::any)",
-                                         fileName, fileLine, function);
-        return {};
+        return;
     }
-
-    auto res = LoggerUtil::anyToString(fileName, fileLine, function, data);
-    if (!res.has_value())
+    if (!data.has_value())
+    {
+        active->logger->debug("[{}:{}][{}] anyToString: empty std::any", fileName, fileLine, function);
+    }
+    else if (data.type() == typeid(std::nullptr_t))
+    {
+        active->logger->warn("[{}:{}][{}] anyToString: std::any holds nullptr_t (prefer empty std::any)",
+                             fileName, fileLine, function);
+    }
+    else
     {
         // 建议 debug 或做采样/去重
-        getInstance().getLogger()->debug("[{}:{}][{}] anyToString: convert failed, type={}", fileName, fileLine,
-                                          function, data.type().name());
-        return {};
-        // 或 return "<convert-failed>";
+        active->logger->debug("[{}:{}][{}] anyToString: convert failed, type={}", fileName, fileLine,
+                              function, data.type().name());
     }
-    return res.value();
 }
@@ -8,10 +8,23 @@
   * ************************************************/
 #ifndef COREXI_COMMON_PC_LOGGER_P_H
 #define COREXI_COMMON_PC_LOGGER_P_H
+#include "async_sink.hpp"
+#include "config_watcher.hpp"
+#include "cow_dist_sink.hpp"
+#include "deferred_format_sink.hpp"
+#include "epoch.hpp"
 #include "id8generator.hpp"
+#include "logger_stats.hpp"
+#include "logsite_registry.hpp"
+#include "retire_queue.hpp"
+#include <array>
+#include <atomic>
 #include <logger/logger.h>
 #include <memory>
+#include <mutex>
+#include <spdlog/async.h>
 #include <spdlog/spdlog.h>
+#include <vector>
 
 class LogPrivate
 {
@@ -105,6 +118,56 @@ public:
 	 */
 	static void critical(const char* fileName, int fileLine, const char* function, const std::initializer_list<std::any>& msgList);
 
+	/**
+	 * 输出已拼接好的日志文本（Logger::log 模板的落地实现）
+	 * @param level 日志级别
+	 * @param fileName 日志输出位置文件名
+	 * @param fileLine 日志输出位置行号
+	 * @param function 日志输出所在函数
+	 * @param msg 日志文本
+	 * @param msgCount 原始参数个数
+	 */
+	static void logText(LogLevel level, const char* fileName, int fileLine, const char* function,
+						std::string_view msg, std::size_t msgCount);
+
+	/**
+	 * 投递一条延迟格式化记录（Logger::log 模板的落地实现），格式化在分发 sink 上完成（异步模式下即线程池）
+	 * @param level 日志级别
+	 * @param fileName 日志输出位置文件名
+	 * @param fileLine 日志输出位置行号
+	 * @param function 日志输出所在函数
+	 * @param record 记录首地址
+	 * @param size 记录字节数
+	 */
+	static void logRecord(LogLevel level, const char* fileName, int fileLine, const char* function,
+						  char* record, std::size_t size);
+
+	/**
+	 * 输出调用点日志文本，首次调用时注册调用点，前缀使用注册时缓存的 "[文件:行号][函数]"
+	 * @param site 调用点描述符
+	 * @param msg 日志文本
+	 * @param msgCount 原始参数个数
+	 */
+	static void logText(const LogSite& site, std::string_view msg, std::size_t msgCount);
+
+	/**
+	 * 投递一条调用点延迟格式化记录，首次调用时注册调用点
+	 * @param site 调用点描述符
+	 * @param record 记录首地址
+	 * @param size 记录字节数
+	 */
+	static void logRecord(const LogSite& site, char* record, std::size_t size);
+
+	/**
+	 * 已注册的调用点数量
+	 */
+	static std::uint32_t logSiteCount();
+
+	/**
+	 * 按 ID 查询调用点，ID 无效时返回 nullptr
+	 */
+	static const LogSite* getLogSite(std::uint32_t id);
+
 	/**
      * 创建一个输出到流的日志输出器，并添加到日志对象中
      * 值得注意的是，这种方式不支持输出线程号
@@ -118,9 +181,59 @@ public:
 	 * 添加日志回调函数，每当日志输出时，调用回调函数
 	 * @param logCallBack 日志回调函数
 	 * @param level 日志级别
+	 * @param options 投递方式（同步 / 独立分发线程异步投递）
 	 * @return 回调日志id
 	 */
-	static std::string addCallBackSink(const std::function<void(const LogMsg& logMsg)>& logCallBack, LogLevel level = LogLevel::Trace);
+	static std::string addCallBackSink(const std::function<void(const LogMsg& logMsg)>& logCallBack, LogLevel level = LogLevel::Trace,
+									   const CallbackOptions& options = {});
+
+	/**
+	 * 添加零拷贝视图形式的日志回调函数
+	 * @param logCallBack 日志回调函数
+	 * @param level 日志级别
+	 * @param options 投递方式（同步 / 独立分发线程异步投递）
+	 * @return 回调日志id
+	 */
+	static std::string addCallBackSink(const std::function<void(const LogMsgView& logMsg)>& logCallBack, LogLevel level = LogLevel::Trace,
+									   const CallbackOptions& options = {});
+
+	/**
+	 * 添加批量日志回调函数
+	 * @param logCallBack 批量回调函数
+	 * @param level 日志级别
+	 * @param maxBatch 每批最多条数
+	 * @param maxDelay 一批中首条日志最长等待时间
+	 * @return 回调日志id
+	 */
+	static std::string addBatchCallBackSink(const std::function<void(const LogMsgBatch& batch)>& logCallBack, LogLevel level,
+											std::size_t maxBatch, std::chrono::milliseconds maxDelay);
+
+	/**
+	 * 异步回调因队列满丢弃的日志条数
+	 * @param sinkId 回调日志id
+	 * @return 同步回调或 id 不存在时返回 0
+	 */
+	static std::uint64_t callBackDropCount(const std::string& sinkId);
+
+	/**
+	 * 当前配置的异步队列统计
+	 */
+	static AsyncStats asyncStats();
+
+	/**
+	 * 当前配置中各异步 sink 的统计
+	 */
+	static std::vector<AsyncSinkStats> asyncSinkStats();
+
+	/**
+	 * 配置文件自动重新加载的统计
+	 */
+	static ConfigReloadStats configReloadStats();
+
+	/**
+	 * 日志统计，在 epoch 临界区内读取当前快照的统计范围，不加控制锁
+	 */
+	static LoggerStats getStats();
 
 	/**
 	 * 删除日志回调函数
@@ -135,15 +248,47 @@ public:
 	static void shutdown();
 
 private:
+	// 按 spdlog 级别（trace..critical, off）索引：是否在日志前拼接 [文件:行号][函数]
+	using ShowLineFlags = std::array<bool, spdlog::level::n_levels>;
+	static constexpr ShowLineFlags kDefaultShowLine{false, false, false, true, true, true, false};
+
+	// 配置文件监视选项（logger.watch / watch_debounce_ms / watch_poll_ms）
+	struct WatchOptions
+	{
+		bool enabled = false;
+		std::chrono::milliseconds debounce{200};
+		std::chrono::milliseconds pollInterval{1000};// 仅轮询模式（非 Linux 或 inotify 不可用）使用
+	};
+
+	/**
+	 * 日志热路径使用的当前 logger 快照，经 epoch 保护的裸指针发布（见 epoch.hpp）
+	 * 切换配置时整体替换，旧快照在所有读者离开后才释放
+	 */
+	struct ActiveLogger
+	{
+		std::shared_ptr<spdlog::logger> logger;
+		std::shared_ptr<CustomSink::deferred_format_sink> deferredSink;
+		// 异步 logger 只持有线程池的 weak_ptr，切换配置会替换全局线程池，这里保证旧 logger 退役前线程池仍然存在
+		std::shared_ptr<spdlog::details::thread_pool> threadPool;
+		// 在 logger 之后声明，先于 logger 析构（停止定期输出）：队列探测函数按裸指针访问 logger / 线程池
+		std::shared_ptr<StatsScope> stats;
+		ShowLineFlags showLine = kDefaultShowLine;
+
+		bool showsLine(spdlog::level::level_enum level) const
+		{
+			return level >= 0 && level < spdlog::level::n_levels && showLine[level];
+		}
+	};
+
 	/**
      * 构造
      */
 	LogPrivate();
 
 	/**
-     * 析构，默认
+     * 析构，释放当前快照（进程退出时不再有读者）
      */
-	~LogPrivate() = default;
+	~LogPrivate();
 
 	/**
      * 进行初始化
@@ -152,15 +297,55 @@ private:
 	static LogPrivate& getInstance();
 
 	/**
-     * 获取内部日志对象spdlog指针
+     * 获取内部日志对象spdlog指针（配置、回调管理等低频操作使用，热路径使用 activeLogger）
      * @return
      */
 	std::shared_ptr<spdlog::logger> getLogger();
 
+	/**
+	 * 热路径获取当前快照，调用方必须持有 EpochGuard，快照在 guard 作用域内有效
+	 * @return 日志系统已关闭时返回 nullptr
+	 */
+	const ActiveLogger* activeLogger() const;
+
+	/**
+	 * 以 m_logger / m_deferredSink 的当前状态发布新快照，并退役旧快照
+	 * 加载配置完成后调用
+	 */
+	void publishLogger();
+
+	/**
+	 * 撤下当前快照（之后的日志被丢弃），等待读者离开后释放
+	 */
+	void unpublishLogger();
+
+	/**
+	 * 把旧快照交给后台退役队列，等待读者离开后释放，不阻塞调用方
+	 */
+	void retireLogger(ActiveLogger* old);
+
 	/**
      * 加载指定路径下的日志配置文件
+     * @param keepRuntimeSinks 为 true 时新管线沿用当前的运行时 sink（回调、流输出），用于配置文件自动重新加载
      */
-	void loadConfigFile(const std::string& configFilePath);
+	void loadConfigFile(const std::string& configFilePath, bool keepRuntimeSinks = false);
+
+	/**
+	 * 按当前配置启动、调整或停止配置文件监视
+	 * 须在不持有 m_controlMutex 时调用（监视线程重新加载配置时需要该锁）；在监视线程上调用时不做任何事
+	 */
+	void updateConfigWatcher();
+
+	/**
+	 * 按给定的配置文件与监视选项启动、调整或停止监视，调用方持有 m_watcherMutex
+	 */
+	void applyWatchOptions(const std::string& path, const WatchOptions& options);
+
+	/**
+	 * 监视线程检测到配置文件变化后调用：加载成功则替换当前配置，失败时保留当前配置并计数
+	 * @return 是否继续监视
+	 */
+	bool reloadWatchedConfig(const std::filesystem::path& path, ConfigWatcher::clock::time_point detectedAt);
 
 	/**
      * 创建和加载默认配置
@@ -191,46 +376,105 @@ private:
 	bool checkSinkFilePath(const std::string& sinkType, const std::string& filePath);
 
 	/**
-	 * 日志输出公共实现
+	 * 以新的 id 登记并挂载回调 sink
+	 * @return 回调日志id，日志系统已关闭时为空
+	 */
+	static std::string registerCallBackSink(const std::shared_ptr<spdlog::sinks::sink>& sink, LogLevel level);
+
+	/**
+	 * 向当前 logger 挂载一个运行时 sink（发布新的运行时 sink 列表，打日志的线程无需加锁）
+	 * 调用方持有控制锁，释放后应调用 m_runtimeSinks->reclaim() 回收旧列表
+	 * @param sink
+	 */
+	void attachSink(const std::shared_ptr<spdlog::sinks::sink>& sink);
+
+	/**
+	 * 从当前 logger 卸载运行时 sink，同样需要在释放控制锁后 reclaim
+	 * @param sink
+	 */
+	void detachSink(const std::shared_ptr<spdlog::sinks::sink>& sink);
+
+	/**
+	 * 将 logger 当前过滤级别同步到 Logger::shouldLog 使用的原子镜像
+	 * 每次修改 m_logger 级别后都应调用
+	 */
+	void syncLevelGate();
+
+	/**
+	 * 日志输出公共实现（std::any 接口），拼接后转交文本版本
 	 */
 	static void logImpl(const char* fileName, int fileLine, const char* function,
 						const std::initializer_list<std::any>& msgList,
-						bool showLine, spdlog::level::level_enum level);
+						spdlog::level::level_enum level);
 
 	/**
-	 * 用于拼接字符串
+	 * 日志输出公共实现（已拼接文本），是否拼接 [文件:行号][函数] 由当前快照决定
 	 */
-	static std::string linkString(const char* fileName, int fileLine, const char* function, const std::initializer_list<std::any>& msgList);
+	static void logImpl(const char* fileName, int fileLine, const char* function,
+						std::string_view msg, std::size_t msgCount,
+						spdlog::level::level_enum level);
 
 	/**
-	 * 浮点数转字符串,保留7位有效数字
-	 * @param value
-	 * @return
+	 * 拼接字符串：各参数就地追加到 out，不生成临时字符串
 	 */
-	static std::string floatingNumToString(double value);
+	static void linkString(const char* fileName, int fileLine, const char* function,
+						   const std::initializer_list<std::any>& msgList, std::string& out);
 
 	/**
-	 * std::any数据转string
+	 * std::any数据追加到 out，转换失败时输出诊断日志，out 不变
 	 * @param fileName
 	 * @param fileLine
 	 * @param function
 	 * @param data
-	 * @return
+	 * @param out
 	 */
-	static std::string anyToString(const char* fileName, int fileLine, const char* function, const std::any& data);
+	static void appendAny(const char* fileName, int fileLine, const char* function, const std::any& data,
+						  std::string& out);
 
 private:
 	// spdlog库logger类对象指针
 	std::shared_ptr<spdlog::logger> m_logger;
 
-	static std::string m_configFilePath;
+	// 延迟格式化模式（async_deferred_format 或配置了 binary_file_mt）下的分发sink，未启用时为空
+	std::shared_ptr<CustomSink::deferred_format_sink> m_deferredSink;
 
-	static bool m_traceShowLine;
-	static bool m_debugShowLine;
-	static bool m_infoShowLine;
-	static bool m_warnShowLine;
-	static bool m_errorShowLine;
-	static bool m_criticalShowLine;
+	// 运行时增删的 sink（回调、流输出），作为固定子 sink 挂在 logger（延迟格式化模式下为分发 sink）上
+	std::shared_ptr<CustomSink::cow_dist_sink> m_runtimeSinks;
+
+	// 调用点注册表，与配置无关，重新加载配置时保留
+	LogSiteRegistry m_siteRegistry;
+
+	// 热路径读取的当前快照（epoch 保护），日志系统关闭后为空
+	std::atomic<ActiveLogger*> m_active{nullptr};
+
+	// 当前配置的异步线程池（同步模式为空），不使用 spdlog 的全局线程池，切换配置时新旧线程池互不影响
+	std::shared_ptr<spdlog::details::thread_pool> m_threadPool;
+	std::size_t m_asyncQueueCapacity = 0;
+
+	// 当前配置中 async: true 的 sink（仅用于统计）
+	std::vector<std::shared_ptr<CustomSink::async_sink>> m_asyncSinks;
+
+	// 当前配置的统计范围（各 sink 计数、队列探测、定期输出），随快照发布
+	std::shared_ptr<StatsScope> m_stats;
+
+	// 当前配置的行号显示开关，随快照发布
+	ShowLineFlags m_showLine = kDefaultShowLine;
+
+	// 退役的旧快照在后台等待读者离开后释放，析构时处理完剩余快照
+	RetireQueue m_retireQueue;
+
+	// 当前配置的监视选项与监视线程
+	WatchOptions m_watchOptions;
+	ConfigWatcher m_configWatcher;
+	ConfigReloadStats m_reloadStats;// 受 m_controlMutex 保护
+
+	// 串行化监视线程的启停（不能用 m_controlMutex：停止时要等待可能正在重新加载配置的监视线程）
+	static std::mutex m_watcherMutex;
+
+	// 串行化配置切换、回调增删、关闭等低频操作
+	static std::mutex m_controlMutex;
+
+	static std::string m_configFilePath;
 
 	static std::unordered_map<std::string, std::shared_ptr<spdlog::sinks::sink>> m_callbackSinks;
 
@@ -0,0 +1,243 @@
+/*************************************************
+  * 描述：日志统计的汇总（Logger::getStats）
+  *
+  *  - stats_sink：挂在每个 logger 的 sink 列表末尾，统计本配置交给 sink 的日志条数（按级别）与 logger 级刷新次数，
+  *    异步模式下由 worker 每处理 256 条采样一次队列深度，记录高水位
+  *  - StatsScope：一份配置的统计范围（各 sink、运行时 sink、stats_sink 与定期输出线程），随日志快照发布与退役，
+  *    collect() 只读原子计数，运行时 sink 在 epoch 临界区内遍历
+  *  - 丢弃：只有 per_thread 队列能按级别计数；shared 队列、sink 级异步队列与异步回调队列的丢弃不区分级别，
+  *    汇总时计入 total.dropped
+  *
+  * spdlog 自带的 sink 没有计数，其写入 / 过滤条数由 stats_sink 的按级别计数与 sink 级别推算（SinkStats::detailed 为 false）
+  *
+  * File：logger_stats.hpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#ifndef COREXI_COMMON_PC_LOGGER_STATS_HPP
+#define COREXI_COMMON_PC_LOGGER_STATS_HPP
+
+#include "async_sink.hpp"
+#include "cow_dist_sink.hpp"
+#include "sink_counters.hpp"
+#include "stats_reporter.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <logger/logger.h>
+#include <memory>
+#include <spdlog/details/log_msg.h>
+#include <spdlog/sinks/sink.h>
+#include <string>
+#include <vector>
+
+namespace CustomSink
+{
+	/// 统计本配置交给 sink 的日志条数与 logger 级刷新次数，并采样异步队列深度
+	class stats_sink : public spdlog::sinks::sink
+	{
+	public:
+		void log(const spdlog::details::log_msg& msg) override
+		{
+			processed_.add(msg.level);
+			LogStatistics::instance().written.add(msg.level);
+			thread_local unsigned tick = 0;
+			if (depth_probe_ && (++tick & 0xff) == 0)
+				queue_depth();
+		}
+
+		void flush() override
+		{
+			flushes_.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void set_pattern(const std::string&) override {}
+
+		void set_formatter(std::unique_ptr<spdlog::formatter>) override {}
+
+		/**
+		 * 设置异步队列的探测函数，须在 logger 发布之前调用
+		 * @param depth 当前队列深度
+		 * @param dropped 因队列满丢弃 / 覆盖的累计条数
+		 * @param droppedByLevel 丢弃已按级别计入 LogStatistics::dropped（per_thread 队列），汇总时不再重复计入
+		 */
+		void set_queue_probes(std::function<std::size_t()> depth, std::function<std::uint64_t()> dropped,
+							  bool droppedByLevel = false)
+		{
+			depth_probe_ = std::move(depth);
+			dropped_probe_ = std::move(dropped);
+			dropped_by_level_ = droppedByLevel;
+		}
+
+		bool queue_dropped_by_level() const
+		{
+			return dropped_by_level_;
+		}
+
+		bool async() const
+		{
+			return static_cast<bool>(depth_probe_);
+		}
+
+		/// 当前队列深度，同时更新高水位
+		std::size_t queue_depth()
+		{
+			if (!depth_probe_)
+				return 0;
+			const std::size_t depth = depth_probe_();
+			std::size_t high = high_water_.load(std::memory_order_relaxed);
+			while (depth > high && !high_water_.compare_exchange_weak(high, depth, std::memory_order_relaxed))
+			{
+			}
+			return depth;
+		}
+
+		std::size_t queue_high_water() const
+		{
+			return high_water_.load(std::memory_order_relaxed);
+		}
+
+		std::uint64_t queue_dropped() const
+		{
+			return dropped_probe_ ? dropped_probe_() : 0;
+		}
+
+		std::uint64_t processed(std::size_t level) const
+		{
+			return processed_.load(level);
+		}
+
+		std::uint64_t flushes() const
+		{
+			return flushes_.load(std::memory_order_relaxed);
+		}
+
+	private:
+		LevelCounters processed_;
+		std::atomic<std::uint64_t> flushes_{0};
+		std::atomic<std::size_t> high_water_{0};
+		std::function<std::size_t()> depth_probe_;
+		std::function<std::uint64_t()> dropped_probe_;
+		bool dropped_by_level_ = false;
+	};
+}// namespace CustomSink
+
+/// 一份配置的统计范围，随日志快照发布，退役时先停止定期输出
+struct StatsScope
+{
+	struct SinkEntry
+	{
+		std::string label;
+		std::shared_ptr<spdlog::sinks::sink> sink;
+		const CustomSink::sink_counters* counters = nullptr;// sink 自行计数时非空
+		std::shared_ptr<CustomSink::async_sink> asyncSink;  // sink 级异步时的外层 sink
+	};
+
+	/// 登记配置中的一个 sink（sink 为异步外层时按其内层 sink 计数）
+	void addSink(std::string label, const std::shared_ptr<spdlog::sinks::sink>& sink,
+				 const std::shared_ptr<CustomSink::async_sink>& asyncSink = nullptr)
+	{
+		SinkEntry entry;
+		entry.label = std::move(label);
+		entry.sink = sink;
+		if (auto counted = dynamic_cast<const CustomSink::counted_sink*>(sink.get()))
+			entry.counters = &counted->counters();
+		entry.asyncSink = asyncSink;
+		sinks.push_back(std::move(entry));
+	}
+
+	/// 汇总统计；运行时 sink 在 epoch 临界区内遍历，不加锁
+	LoggerStats collect() const
+	{
+		LoggerStats stats;
+		auto& global = LogStatistics::instance();
+		for (std::size_t level = 0; level < LevelCounters::kLevels; ++level)
+		{
+			LevelStats& s = stats.levels[level];
+			s.accepted = global.accepted.load(level);
+			s.filtered = global.filtered.load(level);
+			s.dropped = global.dropped.load(level);
+			s.written = global.written.load(level);
+			stats.total.accepted += s.accepted;
+			stats.total.filtered += s.filtered;
+			stats.total.dropped += s.dropped;
+			stats.total.written += s.written;
+		}
+		if (!statsSink)
+			return stats;
+
+		std::array<std::uint64_t, LevelCounters::kLevels> processed{};
+		for (std::size_t level = 0; level < processed.size(); ++level)
+			processed[level] = statsSink->processed(level);
+		for (const auto& entry: sinks)
+			stats.sinks.push_back(sinkStats(entry.label, *entry.sink, entry.counters, processed, entry.asyncSink.get()));
+		if (runtimeSinks)
+		{
+			std::size_t index = 0;
+			runtimeSinks->for_each([&](const std::shared_ptr<spdlog::sinks::sink>& sink) {
+				const auto* counted = dynamic_cast<const CustomSink::counted_sink*>(sink.get());
+				std::string label = counted && !counted->stats_label().empty() ? counted->stats_label()
+																				 : "runtime#" + std::to_string(index);
+				stats.sinks.push_back(sinkStats(std::move(label), *sink, counted ? &counted->counters() : nullptr, processed, nullptr));
+				++index;
+			});
+		}
+
+		stats.async = statsSink->async();
+		stats.queueDepth = statsSink->queue_depth();
+		stats.queueHighWater = statsSink->queue_high_water();
+		stats.queueDropped = statsSink->queue_dropped();
+		stats.flushes = statsSink->flushes();
+
+		// 不区分级别的丢弃（shared 队列、sink 级异步队列、异步 / 批量回调队列）只计入 total
+		if (!statsSink->queue_dropped_by_level())
+			stats.total.dropped += stats.queueDropped;
+		for (const SinkStats& s: stats.sinks)
+			stats.total.dropped += s.dropped;
+		return stats;
+	}
+
+	std::shared_ptr<CustomSink::stats_sink> statsSink;
+	std::vector<SinkEntry> sinks;
+	std::shared_ptr<CustomSink::cow_dist_sink> runtimeSinks;
+	std::unique_ptr<StatsReporter> reporter;// 最后声明：最先停止，停止前的最后一次输出仍可访问其余成员
+
+private:
+	static SinkStats sinkStats(std::string label, const spdlog::sinks::sink& sink, const CustomSink::sink_counters* counters,
+							   const std::array<std::uint64_t, LevelCounters::kLevels>& processed,
+							   const CustomSink::async_sink* asyncSink)
+	{
+		SinkStats s;
+		s.sink = std::move(label);
+		std::uint64_t accepted = 0;
+		for (std::size_t level = 0; level < processed.size(); ++level)
+		{
+			if (sink.should_log(static_cast<spdlog::level::level_enum>(level)))
+				accepted += processed[level];
+			else
+				s.filtered += processed[level];
+		}
+		if (asyncSink)
+			s.dropped = asyncSink->overrun_count() + asyncSink->discard_count();
+		if (!counters)
+		{
+			s.written = accepted >= s.dropped ? accepted - s.dropped : 0;
+			return s;
+		}
+		s.detailed = true;
+		s.written = counters->written.load(std::memory_order_relaxed);
+		s.bytes = counters->bytes.load(std::memory_order_relaxed);
+		s.rotations = counters->rotations.load(std::memory_order_relaxed);
+		s.rotationTime = std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::nanoseconds(counters->rotation_ns.load(std::memory_order_relaxed)));
+		s.flushes = counters->flushes.load(std::memory_order_relaxed);
+		s.dropped += counters->dropped.load(std::memory_order_relaxed);
+		return s;
+	}
+};
+
+#endif// COREXI_COMMON_PC_LOGGER_STATS_HPP
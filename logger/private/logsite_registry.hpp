@@ -0,0 +1,116 @@
+/*************************************************
+  * 描述：调用点注册表
+  *
+  * 为 LOG_* 宏的静态调用点描述符（LogSite）分配从 1 开始的稠密 ID，并缓存
+  * 预先拼接好的 "[文件:行号][函数]" 前缀，避免每条日志重新格式化
+  *
+  *  - 注册（每个调用点一次）加锁；按 ID 查询无锁：条目按块分配，块指针原子发布，
+  *    条目写完后才发布调用点 ID，读到 ID 的线程一定能看到完整条目
+  *  - 条目地址固定，注册表析构前一直有效
+  *
+  * File：logsite_registry.hpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#ifndef COREXI_COMMON_PC_LOGSITE_REGISTRY_HPP
+#define COREXI_COMMON_PC_LOGSITE_REGISTRY_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <logger/logger.h>
+#include <mutex>
+#include <string>
+
+class LogSiteRegistry
+{
+public:
+	struct Entry
+	{
+		const LogSite* site = nullptr;
+		std::string prefix;// "[文件:行号][函数]"
+	};
+
+	LogSiteRegistry() = default;
+	LogSiteRegistry(const LogSiteRegistry&) = delete;
+	LogSiteRegistry& operator=(const LogSiteRegistry&) = delete;
+
+	~LogSiteRegistry()
+	{
+		for (auto& chunk: m_chunks)
+		{
+			delete[] chunk.load(std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	 * 获取调用点条目，首次调用时注册
+	 * @return 条目；注册表已满时返回 nullptr（调用方退回逐条格式化）
+	 */
+	const Entry* acquire(const LogSite& site)
+	{
+		std::uint32_t id = site.id.load(std::memory_order_acquire);
+		if (id == 0)
+		{
+			id = add(site);
+		}
+		return find(id);
+	}
+
+	/**
+	 * 按 ID 查询，ID 无效时返回 nullptr
+	 */
+	const Entry* find(std::uint32_t id) const
+	{
+		if (id == 0 || id > m_size.load(std::memory_order_acquire))
+			return nullptr;
+		const std::uint32_t index = id - 1;
+		const Entry* chunk = m_chunks[index >> kChunkBits].load(std::memory_order_acquire);
+		return chunk ? &chunk[index & (kChunkSize - 1)] : nullptr;
+	}
+
+	std::uint32_t size() const
+	{
+		return m_size.load(std::memory_order_acquire);
+	}
+
+private:
+	static constexpr std::uint32_t kChunkBits = 10;
+	static constexpr std::uint32_t kChunkSize = 1u << kChunkBits;
+	static constexpr std::uint32_t kMaxChunks = 1024;// 最多约 100 万个调用点
+
+	std::uint32_t add(const LogSite& site)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		std::uint32_t id = site.id.load(std::memory_order_relaxed);// 其他线程可能已经注册
+		if (id != 0)
+			return id;
+
+		const std::uint32_t index = m_size.load(std::memory_order_relaxed);
+		if (index >= kChunkSize * kMaxChunks)
+			return 0;
+
+		Entry* chunk = m_chunks[index >> kChunkBits].load(std::memory_order_relaxed);
+		if (!chunk)
+		{
+			chunk = new Entry[kChunkSize];
+			m_chunks[index >> kChunkBits].store(chunk, std::memory_order_release);
+		}
+		Entry& entry = chunk[index & (kChunkSize - 1)];
+		entry.site = &site;
+		entry.prefix.append("[").append(site.file ? site.file : "").append(":");
+		entry.prefix.append(std::to_string(site.line)).append("][");
+		entry.prefix.append(site.function ? site.function : "").append("]");
+
+		id = index + 1;
+		m_size.store(id, std::memory_order_release);
+		site.id.store(id, std::memory_order_release);
+		return id;
+	}
+
+	std::atomic<Entry*> m_chunks[kMaxChunks] = {};
+	std::atomic<std::uint32_t> m_size{0};
+	std::mutex m_mutex;
+};
+
+#endif// COREXI_COMMON_PC_LOGSITE_REGISTRY_HPP
@@ -0,0 +1,133 @@
+/*************************************************
+  * 描述：有界无锁多生产者多消费者队列（Vyukov 环形队列）
+  *
+  *  - 每个槽位带序号，生产者/消费者各自 CAS 推进位置后只访问自己占到的槽位，不加锁
+  *  - 槽位中的对象常驻复用：入队时由调用方就地填写（如 string::assign 复用已有容量），稳态下不分配内存
+  *  - 容量向上取整为 2 的幂
+  *  - 生产者也可以出队（丢弃最旧的一条给新消息腾位置）
+  *
+  * File：mpmc_queue.hpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#ifndef COREXI_COMMON_PC_MPMC_QUEUE_HPP
+#define COREXI_COMMON_PC_MPMC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+template<typename T>
+class MpmcQueue
+{
+public:
+	explicit MpmcQueue(std::size_t capacity)
+	{
+		std::size_t size = 2;
+		while (size < capacity)
+			size <<= 1;
+		m_mask = size - 1;
+		m_cells = std::make_unique<Cell[]>(size);
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			m_cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	MpmcQueue(const MpmcQueue&) = delete;
+	MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+	/**
+	 * 尝试入队，fill(T&) 就地填写占到的槽位
+	 * @return 队列已满时返回 false，fill 不会被调用
+	 */
+	template<typename Fill>
+	bool tryPush(Fill&& fill)
+	{
+		std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Cell& cell = m_cells[pos & m_mask];
+			const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+			const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+			if (diff == 0)
+			{
+				if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					fill(cell.data);
+					cell.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = m_enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/**
+	 * 尝试出队，consume(T&) 处理占到的槽位（返回后槽位交还给生产者复用）
+	 * @return 队列为空时返回 false
+	 */
+	template<typename Consume>
+	bool tryPop(Consume&& consume)
+	{
+		std::size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Cell& cell = m_cells[pos & m_mask];
+			const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+			const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+			if (diff == 0)
+			{
+				if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					consume(cell.data);
+					cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = m_dequeuePos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/// 近似的当前元素个数（并发修改时仅供参考）
+	std::size_t sizeApprox() const
+	{
+		const std::size_t enqueued = m_enqueuePos.load(std::memory_order_relaxed);
+		const std::size_t dequeued = m_dequeuePos.load(std::memory_order_relaxed);
+		return enqueued > dequeued ? enqueued - dequeued : 0;
+	}
+
+	std::size_t capacity() const
+	{
+		return m_mask + 1;
+	}
+
+private:
+	struct Cell
+	{
+		std::atomic<std::size_t> sequence{0};
+		T data{};
+	};
+
+	std::unique_ptr<Cell[]> m_cells;
+	std::size_t m_mask = 0;
+	alignas(64) std::atomic<std::size_t> m_enqueuePos{0};
+	alignas(64) std::atomic<std::size_t> m_dequeuePos{0};
+};
+
+#endif// COREXI_COMMON_PC_MPMC_QUEUE_HPP
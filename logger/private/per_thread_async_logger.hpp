@@ -0,0 +1,421 @@
+/*************************************************
+  * 描述：按线程分队列的异步 logger（async_queue: per_thread）
+  *
+  * spdlog 的线程池队列（mpmc_blocking_q）所有生产者共用一把互斥锁和条件变量，打日志的线程越多争用越重。
+  * per_thread_async_logger 改为每个打日志的线程一条单生产者单消费者环形队列（spsc_ring.hpp）：
+  *  - 线程第一次向该 logger 打日志时创建并登记自己的队列，之后入队只有一次原子写，线程之间不争用
+  *  - 单个 worker 线程按时间戳归并各队列：每个队列一个游标，反复取各游标处时间最早的一条，攒满一批（batch_size）
+  *    或所有队列都取空后整批写出，再一次性出队；实现 batch_sink 的 sink 整批只加一次锁、一次写出，其余 sink 逐条 log()
+  *  - 线程退出（或改用另一个 logger）后其队列被标记为废弃，由 worker 排空后移除
+  *  - 队列满时 block 让出 CPU 等待 worker；discard_new 丢弃新日志；生产者不能出队，overrun_oldest 按 discard_new 处理，
+  *    丢弃的条数同时按级别计入 LogStatistics::dropped
+  *  - flush_on 在入队时判定，由 worker 在写完包含该条的整批后刷新一次；显式 flush() 在 worker 空闲时执行
+  *  - 析构时 worker 写完所有队列中剩余的日志后退出
+  *
+  * 同一线程内的日志保持先后顺序；不同线程之间按入队时已可见的时间戳归并，无法与尚未入队的日志比较
+  *
+  * File：per_thread_async_logger.hpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#ifndef COREXI_COMMON_PC_PER_THREAD_ASYNC_LOGGER_HPP
+#define COREXI_COMMON_PC_PER_THREAD_ASYNC_LOGGER_HPP
+
+#include "batch_file_sink.hpp"
+#include "sink_counters.hpp"
+#include "spsc_ring.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <spdlog/async_logger.h>
+#include <spdlog/logger.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace CustomSink
+{
+	class per_thread_async_logger : public spdlog::logger
+	{
+	public:
+		/**
+		 * @param name logger 名称
+		 * @param begin/end sink 列表（构造后不再增删）
+		 * @param ring_capacity 每个线程的队列容量
+		 * @param overflow_policy 队列满时的处理
+		 * @param batch_size worker 每批最多写出的条数
+		 * @param on_thread_start worker 线程启动时调用（线程名、亲和性等）
+		 */
+		template<typename It>
+		per_thread_async_logger(std::string name, It begin, It end, std::size_t ring_capacity,
+								spdlog::async_overflow_policy overflow_policy, std::size_t batch_size,
+								std::function<void()> on_thread_start)
+			: spdlog::logger(std::move(name), begin, end),
+			  state_(std::make_shared<state>(this->name(), sinks_, ring_capacity, overflow_policy, batch_size)),
+			  id_(next_id_())
+		{
+			worker_ = std::thread([s = state_, start = std::move(on_thread_start)] {
+				s->worker_id.store(std::this_thread::get_id(), std::memory_order_relaxed);
+				if (start)
+					start();
+				s->run();
+			});
+		}
+
+		per_thread_async_logger(const per_thread_async_logger&) = delete;
+		per_thread_async_logger& operator=(const per_thread_async_logger&) = delete;
+
+		~per_thread_async_logger() override
+		{
+			state_->stop.store(true, std::memory_order_seq_cst);
+			state_->wake_worker();
+			if (std::this_thread::get_id() == worker_.get_id())
+			{
+				worker_.detach();// 在 sink 中释放了自身：worker 写完剩余日志后自行退出
+				return;
+			}
+			worker_.join();
+		}
+
+		/// 每个线程的队列容量
+		std::size_t ring_capacity() const
+		{
+			return state_->ring_capacity;
+		}
+
+		/// 当前登记的线程队列个数（含尚未排空的废弃队列）
+		std::size_t ring_count() const
+		{
+			std::lock_guard<std::mutex> lock(state_->rings_mutex);
+			return state_->rings.size();
+		}
+
+		/// 所有线程队列中尚未写入的日志条数
+		std::size_t queue_depth() const
+		{
+			std::lock_guard<std::mutex> lock(state_->rings_mutex);
+			std::size_t depth = 0;
+			for (const auto& ring: state_->rings)
+				depth += ring->queue.sizeApprox();
+			return depth;
+		}
+
+		/// 因队列满被丢弃的日志条数
+		std::uint64_t discard_count() const
+		{
+			return state_->dropped.load(std::memory_order_relaxed);
+		}
+
+		/// worker 已写出的批次数
+		std::uint64_t batch_count() const
+		{
+			return state_->batches.load(std::memory_order_relaxed);
+		}
+
+	protected:
+		void sink_it_(const spdlog::details::log_msg& msg) override
+		{
+			state& s = *state_;
+			producer_ring& ring = local_ring_();
+			const bool flush = should_flush_(msg);
+			auto fill = [&msg, flush](entry& e) {
+				e.time = msg.time;
+				e.source = msg.source;
+				e.level = msg.level;
+				e.thread_id = msg.thread_id;
+				e.flush = flush;
+				e.payload.assign(msg.payload.data(), msg.payload.size());
+			};
+			if (!ring.queue.tryPush(fill))
+			{
+				// worker 自己打日志时不能阻塞等待自己
+				if (s.overflow_policy != spdlog::async_overflow_policy::block ||
+					std::this_thread::get_id() == s.worker_id.load(std::memory_order_relaxed))
+				{
+					s.dropped.fetch_add(1, std::memory_order_relaxed);
+					LogStatistics::instance().dropped.add(msg.level);
+					return;
+				}
+				while (!ring.queue.tryPush(fill))
+				{
+					s.wake_worker();
+					std::this_thread::yield();
+				}
+			}
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (s.sleeping.load(std::memory_order_relaxed))
+				s.wake_worker();
+		}
+
+		// flush_on 已在入队时判定，这里只处理显式 flush()：请求 worker 空闲时刷新，不等待
+		void flush_() override
+		{
+			state_->flush_requested.store(true, std::memory_order_relaxed);
+			state_->wake_worker();
+		}
+
+	private:
+		/// 队列中的一条日志（原始字段的拷贝，logger 名称由 worker 补上）
+		struct entry
+		{
+			spdlog::log_clock::time_point time;
+			spdlog::source_loc source;
+			spdlog::level::level_enum level = spdlog::level::trace;
+			std::size_t thread_id = 0;
+			bool flush = false;// 写入后刷新（flush_on）
+			std::string payload;
+		};
+
+		struct producer_ring
+		{
+			explicit producer_ring(std::size_t capacity)
+				: queue(capacity) {}
+
+			SpscRing<entry> queue;
+			std::atomic<bool> abandoned{false};// 生产者线程已退出或改用其他 logger，不会再入队
+		};
+
+		/// 各线程队列与 worker 的共享状态，logger 在 worker 内被析构时由 worker 继续持有
+		struct state
+		{
+			state(const std::string& logger_name, std::vector<spdlog::sink_ptr> logger_sinks, std::size_t capacity,
+				  spdlog::async_overflow_policy policy, std::size_t max_batch)
+				: name(logger_name), sinks(std::move(logger_sinks)), ring_capacity(std::max<std::size_t>(capacity, 2)),
+				  overflow_policy(policy), batch_size(std::max<std::size_t>(max_batch, 1))
+			{
+				for (const auto& sink: sinks)
+					batch_sinks.push_back(dynamic_cast<batch_sink*>(sink.get()));
+			}
+
+			std::shared_ptr<producer_ring> add_ring()
+			{
+				auto ring = std::make_shared<producer_ring>(ring_capacity);
+				std::lock_guard<std::mutex> lock(rings_mutex);
+				rings.push_back(ring);
+				rings_version.fetch_add(1, std::memory_order_seq_cst);
+				return ring;
+			}
+
+			void wake_worker()
+			{
+				std::lock_guard<std::mutex> lock(wake_mutex);
+				wake.notify_one();
+			}
+
+			void run()
+			{
+				std::vector<std::shared_ptr<producer_ring>> local;
+				std::vector<std::size_t> cursors;
+				std::vector<spdlog::details::log_msg> batch;
+				batch.reserve(batch_size);
+				std::uint64_t version = ~std::uint64_t(0);
+				for (;;)
+				{
+					// 先读停止标志：停止前入队的日志此后一定可见
+					const bool stopping = stop.load(std::memory_order_acquire);
+					refresh_(local, version);
+
+					// 归并：反复取各游标处时间最早的一条，日志仍留在队列中（payload 直接引用槽位），写完后再出队
+					cursors.assign(local.size(), 0);
+					batch.clear();
+					bool flush = false;
+					while (batch.size() < batch_size)
+					{
+						std::size_t earliest = 0;
+						const entry* first = nullptr;
+						for (std::size_t i = 0; i < local.size(); ++i)
+						{
+							const entry* e = local[i]->queue.peek(cursors[i]);
+							if (e && (!first || e->time < first->time))
+							{
+								earliest = i;
+								first = e;
+							}
+						}
+						if (!first)
+							break;
+						batch.emplace_back(first->time, first->source, name, first->level,
+										   spdlog::string_view_t(first->payload.data(), first->payload.size()));
+						batch.back().thread_id = first->thread_id;
+						flush = flush || first->flush;
+						++cursors[earliest];
+					}
+					if (!batch.empty())
+					{
+						write_(batch, flush);
+						for (std::size_t i = 0; i < local.size(); ++i)
+						{
+							if (cursors[i] > 0)
+								local[i]->queue.pop(cursors[i]);
+						}
+						continue;
+					}
+
+					// 所有队列均为空
+					if (flush_requested.exchange(false, std::memory_order_relaxed))
+						flush_sinks_();
+					if (stopping)
+					{
+						flush_sinks_();
+						return;
+					}
+					prune_(local, version);
+					sleep_(local, version);
+				}
+			}
+
+			const std::string name;
+			const std::vector<spdlog::sink_ptr> sinks;
+			const std::size_t ring_capacity;
+			const spdlog::async_overflow_policy overflow_policy;
+			const std::size_t batch_size;
+			std::vector<batch_sink*> batch_sinks;// 与 sinks 一一对应，不支持批量写入的为空
+			std::atomic<std::uint64_t> dropped{0};
+			std::atomic<std::uint64_t> batches{0};
+			std::atomic<bool> stop{false};
+			std::atomic<bool> sleeping{false};
+			std::atomic<bool> flush_requested{false};
+			std::mutex wake_mutex;
+			std::condition_variable wake;
+			mutable std::mutex rings_mutex;
+			std::vector<std::shared_ptr<producer_ring>> rings;// 受 rings_mutex 保护，worker 使用其副本
+			std::atomic<std::uint64_t> rings_version{0};
+			std::atomic<std::thread::id> worker_id{};// worker 启动时自行写入，生产者线程并发读取
+
+		private:
+			void refresh_(std::vector<std::shared_ptr<producer_ring>>& local, std::uint64_t& version)
+			{
+				const auto current = rings_version.load(std::memory_order_acquire);
+				if (current == version)
+					return;
+				std::lock_guard<std::mutex> lock(rings_mutex);
+				local = rings;
+				version = rings_version.load(std::memory_order_relaxed);
+			}
+
+			/// 移除已废弃且已排空的队列（先读废弃标志再确认为空，此后生产者不会再入队）
+			void prune_(std::vector<std::shared_ptr<producer_ring>>& local, std::uint64_t& version)
+			{
+				const bool any = std::any_of(local.begin(), local.end(), [](const std::shared_ptr<producer_ring>& ring) {
+					return ring->abandoned.load(std::memory_order_acquire) && !ring->queue.front();
+				});
+				if (!any)
+					return;
+				std::lock_guard<std::mutex> lock(rings_mutex);
+				rings.erase(std::remove_if(rings.begin(), rings.end(),
+										   [](const std::shared_ptr<producer_ring>& ring) {
+											   return ring->abandoned.load(std::memory_order_acquire) &&
+													  !ring->queue.front();
+										   }),
+							rings.end());
+				rings_version.fetch_add(1, std::memory_order_relaxed);
+				local = rings;
+				version = rings_version.load(std::memory_order_relaxed);
+			}
+
+			/// 休眠前再确认一次没有新日志与新队列，由生产者唤醒或超时
+			void sleep_(const std::vector<std::shared_ptr<producer_ring>>& local, std::uint64_t version)
+			{
+				std::unique_lock<std::mutex> lock(wake_mutex);
+				sleeping.store(true, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				const bool idle =
+						rings_version.load(std::memory_order_relaxed) == version &&
+						std::none_of(local.begin(), local.end(), [](const std::shared_ptr<producer_ring>& ring) {
+							return ring->queue.sizeApprox() > 0;
+						});
+				if (idle && !stop.load(std::memory_order_relaxed) && !flush_requested.load(std::memory_order_relaxed))
+					wake.wait_for(lock, std::chrono::milliseconds(100));
+				sleeping.store(false, std::memory_order_relaxed);
+			}
+
+			/// 写出一批日志：支持批量写入的 sink 整批交付，其余逐条写入；批中有需要刷新的日志时写完后刷新一次
+			void write_(const std::vector<spdlog::details::log_msg>& batch, bool flush)
+			{
+				for (std::size_t i = 0; i < sinks.size(); ++i)
+				{
+					const auto& sink = sinks[i];
+					try
+					{
+						if (batch_sinks[i])
+						{
+							batch_sinks[i]->log_batch(batch.data(), batch.size());
+							continue;
+						}
+						for (const auto& msg: batch)
+						{
+							if (sink->should_log(msg.level))
+								sink->log(msg);
+						}
+					} catch (const std::exception& ex)
+					{
+						std::cout << "[LogPrivate] 异步写入日志失败: " << ex.what() << std::endl;
+					}
+				}
+				batches.fetch_add(1, std::memory_order_relaxed);
+				if (flush)
+					flush_sinks_();
+			}
+
+			void flush_sinks_()
+			{
+				for (const auto& sink: sinks)
+				{
+					try
+					{
+						sink->flush();
+					} catch (const std::exception& ex)
+					{
+						std::cout << "[LogPrivate] 异步刷新日志失败: " << ex.what() << std::endl;
+					}
+				}
+			}
+		};
+
+		/// 线程在某个 logger 上的队列，线程退出时标记为废弃
+		struct thread_slot
+		{
+			std::uint64_t owner = 0;
+			std::shared_ptr<producer_ring> ring;
+
+			~thread_slot()
+			{
+				if (ring)
+					ring->abandoned.store(true, std::memory_order_release);
+			}
+		};
+
+		producer_ring& local_ring_()
+		{
+			thread_local thread_slot slot;
+			if (slot.owner != id_)
+			{
+				if (slot.ring)
+					slot.ring->abandoned.store(true, std::memory_order_release);
+				slot.ring = state_->add_ring();
+				slot.owner = id_;
+			}
+			return *slot.ring;
+		}
+
+		/// logger 的唯一编号（不用地址，避免新 logger 复用旧 logger 的地址时误用旧队列）
+		static std::uint64_t next_id_()
+		{
+			static std::atomic<std::uint64_t> counter{0};
+			return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+		}
+
+		std::shared_ptr<state> state_;
+		const std::uint64_t id_;
+		std::thread worker_;
+	};
+}// namespace CustomSink
+
+#endif// COREXI_COMMON_PC_PER_THREAD_ASYNC_LOGGER_HPP
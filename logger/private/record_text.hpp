@@ -0,0 +1,83 @@
+/*************************************************
+  * 描述：延迟格式化记录 -> 日志文本
+  *
+  * deferred_format_sink（worker 线程）与 logger_decode（离线解码工具）共用，
+  * 保证两条路径与即时格式化（LogPrivate::logImpl）输出的文本完全一致
+  *
+  * File：record_text.hpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#ifndef COREXI_COMMON_PC_RECORD_TEXT_HPP
+#define COREXI_COMMON_PC_RECORD_TEXT_HPP
+
+#include <cstdint>
+#include <logger/logrecord.hpp>
+#include <spdlog/common.h>
+#include <string_view>
+
+namespace CustomSink
+{
+	template<typename Out>
+	inline void append_location_prefix(Out& out, const spdlog::source_loc& source)
+	{
+		fmt::format_to(std::back_inserter(out), "[{}:{}][{}]",
+					   source.filename ? source.filename : "", source.line,
+					   source.funcname ? source.funcname : "");
+	}
+
+	/**
+	 * 拼接日志正文：位置前缀 + 参数文本，参数为空或转换失败时输出与即时格式化路径一致的提示
+	 * @param flags 记录 flags（含 kFlagShowLine 时拼接前缀）
+	 * @param argCount 原始参数个数
+	 * @param source 位置信息
+	 * @param out 输出缓冲
+	 * @param appendArgs 追加全部参数文本的回调，数据损坏时返回 false
+	 */
+	template<typename Out, typename AppendArgs>
+	inline void format_message_text(std::uint16_t flags, std::uint16_t argCount, const spdlog::source_loc& source,
+									Out& out, AppendArgs&& appendArgs)
+	{
+		const std::size_t start = out.size();
+		if ((flags & LoggerUtil::LogRecordWriter::kFlagShowLine) != 0)
+		{
+			append_location_prefix(out, source);
+		}
+		const std::size_t prefixEnd = out.size();
+
+		std::string_view hint;
+		if (!appendArgs(out))
+		{
+			hint = " 日志记录解码失败";
+		}
+		else if (out.size() == prefixEnd && argCount > 0)
+		{
+			// 与即时格式化路径的空消息提示保持一致
+			hint = argCount == 1 ? " 日志内容为空" : " 日志打印失败，数据类型转换错误";
+		}
+		if (!hint.empty())
+		{
+			out.resize(start);
+			append_location_prefix(out, source);
+			out.append(hint.data(), hint.data() + hint.size());
+		}
+	}
+
+	/**
+	 * 把记录解码为日志正文追加到 out
+	 * @param reader 记录
+	 * @param source 位置信息（flags 含 kFlagShowLine 时拼接前缀）
+	 * @param out 输出缓冲
+	 * @param float_precision 浮点小数位数，-1 为最短往返表示
+	 */
+	template<typename Out>
+	inline void format_record_text(const LoggerUtil::LogRecordReader& reader, const spdlog::source_loc& source, Out& out,
+								   int float_precision = LoggerUtil::kShortestFloat)
+	{
+		format_message_text(reader.flags(), reader.argCount(), source, out,
+							[&reader, float_precision](Out& o) { return reader.appendText(o, float_precision); });
+	}
+}// namespace CustomSink
+
+#endif// COREXI_COMMON_PC_RECORD_TEXT_HPP
@@ -0,0 +1,108 @@
+/*************************************************
+  * 描述：后台退役队列
+  *
+  * 配置切换后，旧的日志管线（logger、sink、异步线程池）交给后台线程：
+  * 先等待仍在 epoch 临界区内使用旧管线的读者全部离开，再释放对象（异步线程池析构时排空队列）
+  *  - retire() 只入队，不等待，切换配置的线程与打日志的线程都不会被阻塞
+  *  - drain() 等待已入队的对象全部释放，用于 shutdown 等需要确保旧日志落盘的场合
+  *  - 后台线程在首次 retire() 时启动，析构时处理完剩余对象后退出
+  *
+  * File：retire_queue.hpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#ifndef COREXI_COMMON_PC_RETIRE_QUEUE_HPP
+#define COREXI_COMMON_PC_RETIRE_QUEUE_HPP
+
+#include "epoch.hpp"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class RetireQueue
+{
+public:
+	RetireQueue() = default;
+	RetireQueue(const RetireQueue&) = delete;
+	RetireQueue& operator=(const RetireQueue&) = delete;
+
+	~RetireQueue()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_wake.notify_one();
+		if (m_thread.joinable())
+			m_thread.join();
+	}
+
+	/// 入队一个待释放对象（类型由 shared_ptr 的删除器擦除），空指针忽略
+	void retire(std::shared_ptr<void> object)
+	{
+		if (!object)
+			return;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_pending.push_back(std::move(object));
+			if (!m_thread.joinable())
+				m_thread = std::thread(&RetireQueue::run, this);
+		}
+		m_wake.notify_one();
+	}
+
+	/**
+	 * 等待已入队的对象全部释放
+	 * @return false 表示当前线程处于 epoch 临界区（如在同步回调中调用），等待会与后台线程互相等待，因此直接返回
+	 */
+	bool drain()
+	{
+		if (EpochDomain::instance().inCritical())
+			return false;
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_idle.wait(lock, [this] { return m_pending.empty() && !m_busy; });
+		return true;
+	}
+
+	/// 已退役但尚未释放的对象个数
+	std::size_t pending()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_pending.size() + (m_busy ? 1 : 0);
+	}
+
+private:
+	void run()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		for (;;)
+		{
+			m_wake.wait(lock, [this] { return m_stop || !m_pending.empty(); });
+			if (m_pending.empty())
+				return;// 已停止且处理完毕
+
+			std::vector<std::shared_ptr<void>> batch;
+			batch.swap(m_pending);
+			m_busy = true;
+			lock.unlock();
+			EpochDomain::instance().synchronize();// 后台线程不在临界区内，总能等到
+			batch.clear();
+			lock.lock();
+			m_busy = false;
+			m_idle.notify_all();
+		}
+	}
+
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_idle;
+	std::vector<std::shared_ptr<void>> m_pending;
+	bool m_busy = false;
+	bool m_stop = false;
+	std::thread m_thread;
+};
+
+#endif// COREXI_COMMON_PC_RETIRE_QUEUE_HPP
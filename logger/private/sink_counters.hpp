@@ -0,0 +1,154 @@
+/*************************************************
+  * 描述：日志统计的计数器
+  *
+  * 所有计数均为 relaxed 原子量，打日志的线程、sink 与 worker 只做原子加，不加锁：
+  *  - LevelCounters：按级别的计数，分成若干缓存行对齐的分片，每个线程固定加到其中一片，读取时求和，
+  *    多线程打日志时不争用同一缓存行
+  *  - LogStatistics：进程级的按级别计数（accepted / filtered / dropped / written），自进程启动起累计，切换配置不清零
+  *  - sink_counters / counted_sink：自定义 sink 自行维护的计数（写入条数、字节数、滚动次数与耗时、刷新次数、丢弃条数）
+  *
+  * File：sink_counters.hpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#ifndef COREXI_COMMON_PC_SINK_COUNTERS_HPP
+#define COREXI_COMMON_PC_SINK_COUNTERS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <spdlog/common.h>
+#include <string>
+
+/// 按级别（trace ~ critical）的分片计数
+class LevelCounters
+{
+public:
+	static constexpr std::size_t kLevels = 6;
+	static constexpr std::size_t kShards = 16;
+
+	void add(spdlog::level::level_enum level, std::uint64_t count = 1)
+	{
+		const auto index = static_cast<std::size_t>(level);
+		if (index < kLevels)
+			m_shards[shardIndex()].values[index].fetch_add(count, std::memory_order_relaxed);
+	}
+
+	std::uint64_t load(std::size_t level) const
+	{
+		std::uint64_t sum = 0;
+		for (const auto& shard: m_shards)
+			sum += shard.values[level].load(std::memory_order_relaxed);
+		return sum;
+	}
+
+private:
+	struct alignas(64) Shard
+	{
+		std::array<std::atomic<std::uint64_t>, kLevels> values{};
+	};
+
+	/// 线程首次计数时按顺序分配分片
+	static std::size_t shardIndex()
+	{
+		static std::atomic<std::size_t> next{0};
+		thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed) % kShards;
+		return index;
+	}
+
+	std::array<Shard, kShards> m_shards{};
+};
+
+/// 进程级的按级别计数
+class LogStatistics
+{
+public:
+	static LogStatistics& instance()
+	{
+		static LogStatistics statistics;
+		return statistics;
+	}
+
+	LevelCounters accepted;// 进入库内并通过 logger 级别过滤
+	LevelCounters filtered;// 进入库内后被 logger 级别过滤
+	LevelCounters dropped; // 因 per_thread 异步队列满被丢弃
+	LevelCounters written; // 已交给 sink（stats_sink 计数）
+
+private:
+	LogStatistics() = default;
+};
+
+namespace CustomSink
+{
+	/// 自定义 sink 的计数，由 sink 在自身的锁内（或分发线程上）以 relaxed 原子加更新
+	struct sink_counters
+	{
+		std::atomic<std::uint64_t> written{0};
+		std::atomic<std::uint64_t> bytes{0};
+		std::atomic<std::uint64_t> rotations{0};
+		std::atomic<std::uint64_t> rotation_ns{0};
+		std::atomic<std::uint64_t> flushes{0};
+		std::atomic<std::uint64_t> dropped{0};
+
+		void on_write(std::uint64_t messages, std::uint64_t size)
+		{
+			written.fetch_add(messages, std::memory_order_relaxed);
+			bytes.fetch_add(size, std::memory_order_relaxed);
+		}
+
+		void on_flush()
+		{
+			flushes.fetch_add(1, std::memory_order_relaxed);
+		}
+	};
+
+	/// 统计一次滚动及其耗时（作用域结束时计入）
+	class rotation_timer
+	{
+	public:
+		explicit rotation_timer(sink_counters& counters)
+			: counters_(counters), start_(std::chrono::steady_clock::now()) {}
+
+		~rotation_timer()
+		{
+			const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+			counters_.rotations.fetch_add(1, std::memory_order_relaxed);
+			counters_.rotation_ns.fetch_add(static_cast<std::uint64_t>(elapsed.count()), std::memory_order_relaxed);
+		}
+
+		rotation_timer(const rotation_timer&) = delete;
+		rotation_timer& operator=(const rotation_timer&) = delete;
+
+	private:
+		sink_counters& counters_;
+		std::chrono::steady_clock::time_point start_;
+	};
+
+	/// 自行计数的 sink
+	class counted_sink
+	{
+	public:
+		virtual ~counted_sink() = default;
+
+		virtual const sink_counters& counters() const = 0;
+
+		/// 统计中显示的名称（回调 sink 为 "callback:<id>"），挂到日志管线之前设置
+		void set_stats_label(std::string label)
+		{
+			stats_label_ = std::move(label);
+		}
+
+		const std::string& stats_label() const
+		{
+			return stats_label_;
+		}
+
+	private:
+		std::string stats_label_;
+	};
+}// namespace CustomSink
+
+#endif// COREXI_COMMON_PC_SINK_COUNTERS_HPP
@@ -0,0 +1,104 @@
+/*************************************************
+  * 描述：有界单生产者单消费者环形队列
+  *
+  *  - 生产者只写尾指针、消费者只写头指针，入队/出队各一次原子读写，无 CAS、无锁（wait-free）
+  *  - 两端各自缓存对方的指针，只在缓存显示满/空时才重新读取，减少缓存行来回传递
+  *  - 槽位中的对象常驻复用：入队时由调用方就地填写，稳态下不分配内存
+  *  - 消费者可先查看队首之后的若干元素（peek）再一次出队多条，便于多个队列按时间归并成批处理
+  *  - 容量向上取整为 2 的幂
+  *
+  * File：spsc_ring.hpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#ifndef COREXI_COMMON_PC_SPSC_RING_HPP
+#define COREXI_COMMON_PC_SPSC_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+template<typename T>
+class SpscRing
+{
+public:
+	explicit SpscRing(std::size_t capacity)
+	{
+		std::size_t size = 2;
+		while (size < capacity)
+			size <<= 1;
+		m_mask = size - 1;
+		m_slots = std::make_unique<T[]>(size);
+	}
+
+	SpscRing(const SpscRing&) = delete;
+	SpscRing& operator=(const SpscRing&) = delete;
+
+	/**
+	 * 尝试入队（仅生产者线程调用），fill(T&) 就地填写槽位
+	 * @return 队列已满时返回 false，fill 不会被调用
+	 */
+	template<typename Fill>
+	bool tryPush(Fill&& fill)
+	{
+		const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+		if (tail - m_cachedHead > m_mask)
+		{
+			m_cachedHead = m_head.load(std::memory_order_acquire);
+			if (tail - m_cachedHead > m_mask)
+				return false;
+		}
+		fill(m_slots[tail & m_mask]);
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// 队首元素（仅消费者线程调用），队列为空时返回 nullptr
+	T* front()
+	{
+		return peek(0);
+	}
+
+	/// 队首之后第 offset 个元素（仅消费者线程调用），不足 offset + 1 个时返回 nullptr；出队前槽位不会被生产者复用
+	T* peek(std::size_t offset)
+	{
+		const std::size_t pos = m_head.load(std::memory_order_relaxed) + offset;
+		if (pos >= m_cachedTail)
+		{
+			m_cachedTail = m_tail.load(std::memory_order_acquire);
+			if (pos >= m_cachedTail)
+				return nullptr;
+		}
+		return &m_slots[pos & m_mask];
+	}
+
+	/// 出队 count 个元素（仅消费者线程调用，且这些元素已通过 front() / peek() 确认可读）
+	void pop(std::size_t count = 1)
+	{
+		m_head.store(m_head.load(std::memory_order_relaxed) + count, std::memory_order_release);
+	}
+
+	/// 近似的当前元素个数（任意线程调用，仅供参考）
+	std::size_t sizeApprox() const
+	{
+		const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+		const std::size_t head = m_head.load(std::memory_order_relaxed);
+		return tail > head ? tail - head : 0;
+	}
+
+	std::size_t capacity() const
+	{
+		return m_mask + 1;
+	}
+
+private:
+	std::unique_ptr<T[]> m_slots;
+	std::size_t m_mask = 0;
+	alignas(64) std::atomic<std::size_t> m_head{0};// 消费者写
+	std::size_t m_cachedTail = 0;                  // 消费者缓存的尾指针
+	alignas(64) std::atomic<std::size_t> m_tail{0};// 生产者写
+	std::size_t m_cachedHead = 0;                  // 生产者缓存的头指针
+};
+
+#endif// COREXI_COMMON_PC_SPSC_RING_HPP
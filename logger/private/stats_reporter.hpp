@@ -0,0 +1,248 @@
+/*************************************************
+  * 描述：日志统计的定期输出（stats 配置节点）
+  *
+  * 后台线程每隔 interval_ms 取一次统计（Logger::getStats 的同一份数据），输出到：
+  *  - file_path：专用的统计日志文件，每次一行文本摘要
+  *  - prometheus_file：Prometheus 文本格式（node_exporter textfile collector 可直接采集），
+  *    先写临时文件再改名，采集方不会读到写了一半的文件
+  * 两者可同时配置。线程不加日志系统的控制锁，随所属配置退役时停止，停止前再输出一次
+  *
+  * File：stats_reporter.hpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#ifndef COREXI_COMMON_PC_STATS_REPORTER_HPP
+#define COREXI_COMMON_PC_STATS_REPORTER_HPP
+
+#include "batch_file_sink.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <logger/logger.h>
+#include <memory>
+#include <mutex>
+#include <spdlog/logger.h>
+#include <sstream>
+#include <string>
+#include <thread>
+
+struct StatsReportOptions
+{
+	std::chrono::milliseconds interval{0};// 输出间隔，0 表示不输出
+	std::string prometheusFile;           // Prometheus 文本文件路径
+	std::string filePath;                 // 专用统计日志文件路径
+
+	bool enabled() const
+	{
+		return interval.count() > 0 && (!prometheusFile.empty() || !filePath.empty());
+	}
+};
+
+class StatsReporter
+{
+public:
+	using Snapshot = std::function<LoggerStats()>;
+
+	/**
+	 * @param options 输出设置（须 enabled()）
+	 * @param snapshot 取一次统计
+	 * @param onThreadStart 线程启动时调用（线程名、亲和性等）
+	 * @throw spdlog::spdlog_ex 专用统计日志文件无法打开
+	 */
+	StatsReporter(StatsReportOptions options, Snapshot snapshot, std::function<void()> onThreadStart)
+		: m_options(std::move(options)), m_snapshot(std::move(snapshot))
+	{
+		if (!m_options.filePath.empty())
+		{
+			auto sink = std::make_shared<CustomSink::batch_file_sink_mt>(m_options.filePath);
+			m_logger = std::make_shared<spdlog::logger>("logger-stats", sink);
+			m_logger->set_pattern("[%Y-%m-%d %H:%M:%S.%e] %v");
+			m_logger->flush_on(spdlog::level::trace);
+		}
+		m_thread = std::thread([this, start = std::move(onThreadStart)] {
+			if (start)
+				start();
+			run();
+		});
+	}
+
+	StatsReporter(const StatsReporter&) = delete;
+	StatsReporter& operator=(const StatsReporter&) = delete;
+
+	~StatsReporter()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_wake.notify_one();
+		m_thread.join();
+	}
+
+	/// 单行文本摘要
+	static std::string formatText(const LoggerStats& stats)
+	{
+		std::ostringstream out;
+		out << "messages accepted=" << stats.total.accepted << " written=" << stats.total.written
+			<< " filtered=" << stats.total.filtered << " dropped=" << stats.total.dropped;
+		for (std::size_t level = 0; level < stats.levels.size(); ++level)
+		{
+			const LevelStats& s = stats.levels[level];
+			if (s.accepted + s.filtered + s.dropped + s.written == 0)
+				continue;
+			out << " " << kLevelNames[level] << "=" << s.accepted << "/" << s.written << "/" << s.filtered << "/" << s.dropped;
+		}
+		if (stats.async)
+		{
+			out << "; queue depth=" << stats.queueDepth << " high_water=" << stats.queueHighWater
+				<< " dropped=" << stats.queueDropped;
+		}
+		out << "; flushes=" << stats.flushes;
+		for (const SinkStats& s: stats.sinks)
+		{
+			out << "; " << s.sink << " written=" << s.written << " filtered=" << s.filtered << " dropped=" << s.dropped;
+			if (s.detailed)
+			{
+				out << " bytes=" << s.bytes << " rotations=" << s.rotations << " rotation_us=" << s.rotationTime.count()
+					<< " flushes=" << s.flushes;
+			}
+		}
+		return out.str();
+	}
+
+	/// Prometheus 文本格式
+	static std::string formatPrometheus(const LoggerStats& stats)
+	{
+		std::ostringstream out;
+		out << "# HELP logger_messages_total Log messages by level and outcome.\n"
+			<< "# TYPE logger_messages_total counter\n";
+		for (std::size_t level = 0; level < stats.levels.size(); ++level)
+		{
+			const LevelStats& s = stats.levels[level];
+			const std::pair<const char*, std::uint64_t> outcomes[] = {
+					{"accepted", s.accepted}, {"filtered", s.filtered}, {"dropped", s.dropped}, {"written", s.written}};
+			for (const auto& [outcome, value]: outcomes)
+			{
+				out << "logger_messages_total{level=\"" << kLevelNames[level] << "\",outcome=\"" << outcome << "\"} "
+					<< value << "\n";
+			}
+		}
+
+		auto sinkMetric = [&](const char* name, const char* help, auto value) {
+			out << "# HELP " << name << " " << help << "\n# TYPE " << name << " counter\n";
+			for (const SinkStats& s: stats.sinks)
+				out << name << "{sink=\"" << escapeLabel(s.sink) << "\"} " << value(s) << "\n";
+		};
+		sinkMetric("logger_sink_written_total", "Messages written by the sink.", [](const SinkStats& s) { return s.written; });
+		sinkMetric("logger_sink_filtered_total", "Messages below the sink level.", [](const SinkStats& s) { return s.filtered; });
+		sinkMetric("logger_sink_dropped_total", "Messages dropped by the sink queue.", [](const SinkStats& s) { return s.dropped; });
+		sinkMetric("logger_sink_bytes_total", "Bytes written by the sink.", [](const SinkStats& s) { return s.bytes; });
+		sinkMetric("logger_sink_rotations_total", "File rotations performed by the sink.",
+				   [](const SinkStats& s) { return s.rotations; });
+		sinkMetric("logger_sink_rotation_seconds_total", "Time spent rotating files.",
+				   [](const SinkStats& s) { return std::chrono::duration<double>(s.rotationTime).count(); });
+		sinkMetric("logger_sink_flushes_total", "Flushes performed by the sink.", [](const SinkStats& s) { return s.flushes; });
+
+		out << "# HELP logger_flushes_total Logger level flushes.\n# TYPE logger_flushes_total counter\n"
+			<< "logger_flushes_total " << stats.flushes << "\n";
+		if (stats.async)
+		{
+			out << "# HELP logger_async_queue_depth Messages waiting in the async queue.\n"
+				<< "# TYPE logger_async_queue_depth gauge\n"
+				<< "logger_async_queue_depth " << stats.queueDepth << "\n"
+				<< "# HELP logger_async_queue_high_water Highest sampled async queue depth.\n"
+				<< "# TYPE logger_async_queue_high_water gauge\n"
+				<< "logger_async_queue_high_water " << stats.queueHighWater << "\n"
+				<< "# HELP logger_async_queue_dropped_total Messages dropped or overwritten by the async queue.\n"
+				<< "# TYPE logger_async_queue_dropped_total counter\n"
+				<< "logger_async_queue_dropped_total " << stats.queueDropped << "\n";
+		}
+		return out.str();
+	}
+
+private:
+	static constexpr const char* kLevelNames[] = {"trace", "debug", "info", "warn", "error", "critical"};
+
+	static std::string escapeLabel(const std::string& value)
+	{
+		std::string escaped;
+		escaped.reserve(value.size());
+		for (char c: value)
+		{
+			if (c == '\\' || c == '"')
+				escaped += '\\';
+			if (c == '\n')
+			{
+				escaped += "\\n";
+				continue;
+			}
+			escaped += c;
+		}
+		return escaped;
+	}
+
+	void run()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (!m_wake.wait_for(lock, m_options.interval, [this] { return m_stop; }))
+		{
+			lock.unlock();
+			report();
+			lock.lock();
+		}
+		lock.unlock();
+		report();
+	}
+
+	void report()
+	{
+		try
+		{
+			const LoggerStats stats = m_snapshot();
+			if (m_logger)
+				m_logger->info(formatText(stats));
+			if (!m_options.prometheusFile.empty())
+				writePrometheus(formatPrometheus(stats));
+		} catch (const std::exception& ex)
+		{
+			std::cout << "[LogPrivate] 输出日志统计失败: " << ex.what() << std::endl;
+		}
+	}
+
+	void writePrometheus(const std::string& text) const
+	{
+		const std::filesystem::path path(m_options.prometheusFile);
+		std::error_code ec;
+		if (path.has_parent_path())
+			std::filesystem::create_directories(path.parent_path(), ec);
+		const std::filesystem::path temp = path.string() + ".tmp";
+		{
+			std::ofstream file(temp, std::ios::out | std::ios::trunc);
+			file << text;
+			if (!file)
+			{
+				std::cout << "[LogPrivate] 写入日志统计文件失败: " << temp << std::endl;
+				return;
+			}
+		}
+		std::filesystem::rename(temp, path, ec);
+		if (ec)
+			std::cout << "[LogPrivate] 写入日志统计文件失败: " << path << ", " << ec.message() << std::endl;
+	}
+
+	const StatsReportOptions m_options;
+	const Snapshot m_snapshot;
+	std::shared_ptr<spdlog::logger> m_logger;// 专用统计日志，未配置 file_path 时为空
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	bool m_stop = false;
+	std::thread m_thread;
+};
+
+#endif// COREXI_COMMON_PC_STATS_REPORTER_HPP
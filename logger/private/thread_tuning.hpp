@@ -0,0 +1,155 @@
+/*************************************************
+  * 描述：日志后台线程的名称、CPU 亲和性与调度优先级
+  *
+  * 由线程池的 on_thread_start 回调在每个 worker 线程上调用 apply()：
+  *  - 线程名（top -H / perf 中可见），同一线程池的多个 worker 追加序号，按系统限制截断为 15 字节
+  *  - CPU 亲和性：把 worker 限定在给定的 CPU 上，使其避开延迟敏感线程所在的核
+  *  - nice 值或 SCHED_IDLE：降低 worker 的调度优先级
+  * 目前仅在 Linux 上生效，其他平台忽略这些设置
+  *
+  * File：thread_tuning.hpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#ifndef COREXI_COMMON_PC_THREAD_TUNING_HPP
+#define COREXI_COMMON_PC_THREAD_TUNING_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+struct ThreadTuning
+{
+	std::string name;      // 线程名前缀，空表示不设置
+	std::vector<int> cpus; // 允许运行的 CPU，空表示不限制
+	bool setNice = false;
+	int nice = 0;
+	bool schedIdle = false;// 使用 SCHED_IDLE，优先于 nice
+
+	bool empty() const
+	{
+		return name.empty() && cpus.empty() && !setNice && !schedIdle;
+	}
+
+	// CPU 编号上限（不含），与 cpu_set_t 的容量一致
+#ifdef __linux__
+	static constexpr int kMaxCpu = CPU_SETSIZE;
+#else
+	static constexpr int kMaxCpu = 1024;
+#endif
+
+	/**
+	 * 解析 CPU 列表，如 "2,3" 或 "0-3,6"
+	 * @return 格式错误（含多余字符）或编号不小于 kMaxCpu 时返回 false，cpus 不变
+	 */
+	static bool parseCpuList(const std::string& text, std::vector<int>& cpus)
+	{
+		// 整段都必须是数字，std::stoi 会忽略 "2x" 中的多余字符
+		auto parseCpu = [](const std::string& str, int& cpu) {
+			std::size_t pos = 0;
+			cpu = std::stoi(str, &pos);
+			return pos == str.size() && cpu >= 0 && cpu < kMaxCpu;
+		};
+
+		std::vector<int> result;
+		std::stringstream stream(text);
+		std::string item;
+		while (std::getline(stream, item, ','))
+		{
+			item.erase(0, item.find_first_not_of(" \t"));
+			item.erase(item.find_last_not_of(" \t") + 1);
+			if (item.empty())
+				continue;
+			try
+			{
+				const auto dash = item.find('-');
+				int first = 0;
+				int last = 0;
+				if (!parseCpu(item.substr(0, dash), first))
+					return false;
+				if (dash == std::string::npos)
+					last = first;
+				else if (!parseCpu(item.substr(dash + 1), last))
+					return false;
+				if (last < first)
+					return false;
+				for (int cpu = first; cpu <= last; ++cpu)
+					result.push_back(cpu);
+			} catch (...)
+			{
+				return false;
+			}
+		}
+		cpus = std::move(result);
+		return true;
+	}
+
+	/**
+	 * 生成线程池的 on_thread_start 回调（spdlog 无条件调用该回调，未配置任何设置时返回空操作）
+	 * @param name 线程名前缀（覆盖 this->name，为空时使用 this->name）
+	 */
+	std::function<void()> onThreadStart(const std::string& name = {}) const
+	{
+		if (empty() && name.empty())
+			return [] {};
+		ThreadTuning tuning = *this;
+		if (!name.empty())
+			tuning.name = name;
+		auto index = std::make_shared<std::atomic<int>>(0);
+		return [tuning, index] { tuning.apply(index->fetch_add(1, std::memory_order_relaxed)); };
+	}
+
+	/// 在当前线程上应用设置，index 为线程在池中的序号
+	void apply([[maybe_unused]] int index) const
+	{
+#ifdef __linux__
+		if (!name.empty())
+		{
+			std::string threadName = index == 0 ? name : name + "-" + std::to_string(index);
+			threadName.resize(std::min<std::size_t>(threadName.size(), 15));
+			pthread_setname_np(pthread_self(), threadName.c_str());
+		}
+		if (!cpus.empty())
+		{
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			for (int cpu: cpus)
+				CPU_SET(cpu, &set);// parseCpuList 已保证 cpu < CPU_SETSIZE
+			const int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+			if (rc != 0)
+				std::cout << "[LogPrivate] 设置日志线程 CPU 亲和性失败: " << std::strerror(rc) << std::endl;
+		}
+		if (schedIdle)
+		{
+			sched_param param{};
+			if (sched_setscheduler(0, SCHED_IDLE, &param) != 0)
+				std::cout << "[LogPrivate] 设置日志线程 SCHED_IDLE 失败: " << std::strerror(errno) << std::endl;
+		}
+		else if (setNice)
+		{
+			// Linux 下 nice 值按线程生效
+			const auto tid = static_cast<id_t>(::syscall(SYS_gettid));
+			if (setpriority(PRIO_PROCESS, tid, nice) != 0)
+				std::cout << "[LogPrivate] 设置日志线程 nice 值失败: " << std::strerror(errno) << std::endl;
+		}
+#endif
+	}
+};
+
+#endif// COREXI_COMMON_PC_THREAD_TUNING_HPP
@@ -1,6 +1,10 @@
 #include <logger/logger.h>
 #include <logger_p.h>
 
+std::atomic<int> Logger::m_minLevel{static_cast<int>(LogLevel::Trace)};
+std::atomic<bool> Logger::m_deferredFormat{false};
+std::atomic<int> Logger::m_floatPrecision{LoggerUtil::kShortestFloat};
+
 void Logger::setConfigPath(const std::string& configFilePath, bool isDeleteOldConfig)
 {
 	LogPrivate::setConfigPath(configFilePath, isDeleteOldConfig);
@@ -36,10 +40,81 @@ void Logger::critical(const char* fileName, int fileLine, const char* function,
 	LogPrivate::critical(fileName, fileLine, function, msgList);
 }
 
+void Logger::logText(LogLevel level, const char* fileName, int fileLine, const char* function,
+					 std::string_view msg, std::size_t msgCount)
+{
+	LogPrivate::logText(level, fileName, fileLine, function, msg, msgCount);
+}
+
+void Logger::logRecord(LogLevel level, const char* fileName, int fileLine, const char* function,
+					   char* record, std::size_t size)
+{
+	LogPrivate::logRecord(level, fileName, fileLine, function, record, size);
+}
+
+void Logger::logText(const LogSite& site, std::string_view msg, std::size_t msgCount)
+{
+	LogPrivate::logText(site, msg, msgCount);
+}
+
+void Logger::logRecord(const LogSite& site, char* record, std::size_t size)
+{
+	LogPrivate::logRecord(site, record, size);
+}
+
+std::uint32_t Logger::logSiteCount()
+{
+	return LogPrivate::logSiteCount();
+}
+
+const LogSite* Logger::getLogSite(std::uint32_t id)
+{
+	return LogPrivate::getLogSite(id);
+}
+
 std::string Logger::addCallBack(const std::function<void(const LogMsg& logMsg)>& logCallBack, LogLevel level)
 {
 	return LogPrivate::addCallBackSink( logCallBack, level);
 }
+std::string Logger::addCallBack(const std::function<void(const LogMsg& logMsg)>& logCallBack, LogLevel level,
+								const CallbackOptions& options)
+{
+	return LogPrivate::addCallBackSink(logCallBack, level, options);
+}
+std::string Logger::addCallBack(const std::function<void(const LogMsgView& logMsg)>& logCallBack, LogLevel level,
+								const CallbackOptions& options)
+{
+	return LogPrivate::addCallBackSink(logCallBack, level, options);
+}
+std::string Logger::addBatchCallBack(const std::function<void(const LogMsgBatch& batch)>& logCallBack, LogLevel level,
+									 std::size_t maxBatch, std::chrono::milliseconds maxDelay)
+{
+	return LogPrivate::addBatchCallBackSink(logCallBack, level, maxBatch, maxDelay);
+}
+std::uint64_t Logger::callBackDropCount(const std::string& sinkId)
+{
+	return LogPrivate::callBackDropCount(sinkId);
+}
+
+AsyncStats Logger::asyncStats()
+{
+    return LogPrivate::asyncStats();
+}
+
+std::vector<AsyncSinkStats> Logger::asyncSinkStats()
+{
+    return LogPrivate::asyncSinkStats();
+}
+
+ConfigReloadStats Logger::configReloadStats()
+{
+    return LogPrivate::configReloadStats();
+}
+
+LoggerStats Logger::getStats()
+{
+    return LogPrivate::getStats();
+}
 void Logger::removeCallBack(const std::string& sinkId)
 {
 	LogPrivate::removeCallBackSink(sinkId);
@@ -3,16 +3,27 @@
 #include <atomic>
 #include <cassert>
 #include <chrono>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <limits>
 #include <iostream>
 #include <mutex>
+#include <new>
 #include <set>
 #include <sstream>
 #include <string>
 #include <thread>
 #include <vector>
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace fs = std::filesystem;
 
 // ============================================================
@@ -43,6 +54,22 @@ int g_failed = 0;
         }                                   \
     } while (0)
 
+// ============================================================
+// 堆分配计数（替换全局 operator new，仅统计开启计数的线程）
+// ============================================================
+thread_local bool t_countAllocs = false;
+thread_local long t_allocCount = 0;
+
+void* operator new(std::size_t size) {
+    if (t_countAllocs) ++t_allocCount;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
 // ============================================================
 // 配置辅助
 // ============================================================
@@ -76,7 +103,8 @@ void writeSyncConfig(const std::string& path, const std::string& filePath,
 
 // 写一个异步配置文件
 void writeAsyncConfig(const std::string& path, const std::string& filePath,
-                      int queueSize = 8192) {
+                      int queueSize = 8192, const std::string& overflowPolicy = "block",
+                      const std::string& queue = "shared") {
     std::ofstream f(path);
     f << "log_config:\n"
       << "  logger:\n"
@@ -88,6 +116,8 @@ void writeAsyncConfig(const std::string& path, const std::string& filePath,
       << "    async: true\n"
       << "    async_queue_size: " << queueSize << "\n"
       << "    async_thread_count: 1\n"
+      << "    async_overflow_policy: " << overflowPolicy << "\n"
+      << "    async_queue: " << queue << "\n"
       << "  showCodeLine:\n"
       << "    trace: false\n"
       << "    debug: false\n"
@@ -174,6 +204,147 @@ void test_data_types(const std::string& logFile) {
     PASS();
 }
 
+// 2.1) 变参模板接口与 std::any 兼容接口
+void test_variadic_api(const std::string& logFile) {
+    TEST("variadic Logger::log and legacy std::any overloads");
+
+    Logger::log(LogLevel::Info, GET_LINE, "direct_template:", 7, ',', std::string_view("sv"), ',', static_cast<unsigned short>(65535));
+    Logger::info(GET_LINE, {"legacy_any:", 8, std::string("_ok")});
+    LOG_INFO("mixed:", 1ULL, '|', -2LL, '|', 0.5);
+
+    std::string content = readFile(logFile);
+    CHECK(content.find("direct_template:7,sv,65535") != std::string::npos, "template path output mismatch");
+    CHECK(content.find("legacy_any:8_ok") != std::string::npos, "std::any path output mismatch");
+    CHECK(content.find("mixed:1|-2|0.5") != std::string::npos, "macro template path output mismatch");
+    PASS();
+}
+
+// 2.1.1) 扩充类型：模板路径与 std::any 路径输出一致
+void test_extended_types(const std::string& logFile) {
+    TEST("extended types: short/int8/char/enum/duration/string_view/pointer");
+    enum class Color : unsigned char { Red = 1, Blue = 7 };
+    const void* ptr = reinterpret_cast<const void*>(static_cast<std::uintptr_t>(0xbeef));
+
+    LOG_INFO("ext_tpl:", static_cast<short>(-3), ',', static_cast<std::uint8_t>(200), ',', 'c', ',',
+             Color::Blue, ',', std::chrono::milliseconds(15), ',', std::chrono::seconds(2), ',',
+             std::string_view("sv"), ',', ptr, ',', 1.5L);
+    Logger::info(GET_LINE, {"ext_any:", static_cast<short>(-3), ",", static_cast<std::uint8_t>(200), ",", 'c', ",",
+                            static_cast<unsigned long long>(7), ",", std::chrono::milliseconds(15), ",", std::chrono::seconds(2), ",",
+                            std::string_view("sv"), ",", ptr, ",", 1.5L});
+
+    const std::string expected = "-3,200,c,7,15ms,2s,sv,0xbeef,1.5";
+    CHECK(fileContains(logFile, "ext_tpl:" + expected), "template path output mismatch");
+    CHECK(fileContains(logFile, "ext_any:" + expected), "std::any path output mismatch");
+    PASS();
+}
+
+// 2.1.2) 数值格式化：整数边界值、float/double 最短往返表示
+void test_number_format(const std::string& logFile) {
+    TEST("numeric formatting: integer extremes and shortest floats");
+
+    LOG_INFO("num_int:", INT64_MIN, ',', INT64_MAX, ',', UINT64_MAX, ',', 0, ',', -7, ',', 99, ',', 100,
+             ',', static_cast<std::int8_t>(-128));
+    LOG_INFO("num_flt:", 3.14f, ',', 0.1f, ',', -0.0f, ',', 1e-7f, ',', 2.5, ',', 0.1, ',', -0.0, ',', 1e300);
+    Logger::info(GET_LINE, {"num_any:", 3.14f, ",", 0.1, ",", INT64_MIN});
+
+    std::string content = readFile(logFile);
+    CHECK(content.find("num_int:-9223372036854775808,9223372036854775807,18446744073709551615,0,-7,99,100,-128")
+                  != std::string::npos, "integer output mismatch");
+    CHECK(content.find("num_flt:3.14,0.1,0,1e-07,2.5,0.1,0,1e+300") != std::string::npos, "float output mismatch");
+    CHECK(content.find("num_any:3.14,0.1,-9223372036854775808") != std::string::npos, "std::any path mismatch");
+#if defined(__SIZEOF_INT128__) && !defined(__STRICT_ANSI__) // gnu++17 下 __int128 属于整数类型
+    LOG_INFO("num_i128:", ~static_cast<unsigned __int128>(0), ',', std::numeric_limits<__int128>::min());
+    content = readFile(logFile);
+    CHECK(content.find("num_i128:340282366920938463463374607431768211455,"
+                       "-170141183460469231731687303715884105728") != std::string::npos, "__int128 output mismatch");
+#endif
+    PASS();
+}
+
+// 2.1.3) 宽字符串转 UTF-8：ASCII 快速路径、多字节字符、代理、内嵌 0
+void test_wide_strings(const std::string& logFile) {
+    TEST("wide string to UTF-8: ASCII fast path, CJK, surrogates, embedded NUL");
+
+    std::wstring ascii;
+    std::string asciiUtf8;
+    for (int i = 0; i < 100; ++i) { // 覆盖多个 SIMD 块及尾部
+        ascii.push_back(static_cast<wchar_t>('a' + i % 26));
+        asciiUtf8.push_back(static_cast<char>('a' + i % 26));
+    }
+    CHECK(LoggerUtil::wstringToUtf8(ascii) == asciiUtf8, "ascii mismatch");
+
+    // 非 ASCII 出现在 SIMD 块中间：前后的 ASCII 段都要正确
+    const std::wstring mixed = ascii.substr(0, 40) + L"\u4E2D\u6587" + ascii.substr(0, 40);
+    CHECK(LoggerUtil::wstringToUtf8(mixed) == asciiUtf8.substr(0, 40) + "\xE4\xB8\xAD\xE6\x96\x87" + asciiUtf8.substr(0, 40),
+          "mixed mismatch");
+    CHECK(LoggerUtil::wstringToUtf8(L"\u00E9\u07FF\u0800\uFFFD") == "\xC3\xA9\xDF\xBF\xE0\xA0\x80\xEF\xBF\xBD",
+          "2/3-byte boundary mismatch");
+    CHECK(LoggerUtil::wstringToUtf8(L"\U0001F600") == "\xF0\x9F\x98\x80", "supplementary plane mismatch");
+
+    const wchar_t embedded[] = {L'a', 0, L'b'};
+    CHECK(LoggerUtil::wstringToUtf8(std::wstring_view(embedded, 3)) == std::string("a\0b", 3), "embedded NUL dropped");
+
+    // 不成对的代理（UTF-16）或代理区码点（UTF-32）输出 U+FFFD
+    const wchar_t lone[] = {static_cast<wchar_t>(0xD800), L'x'};
+    CHECK(LoggerUtil::wstringToUtf8(std::wstring_view(lone, 2)) == "\xEF\xBF\xBDx", "lone surrogate mismatch");
+
+    const wchar_t* wcstr = L"w\u4E2D";
+    LOG_INFO("wide:", std::wstring(L"\u6587"), ',', wcstr, ',', L'z');
+    Logger::info(GET_LINE, {"wide_any:", std::wstring(L"\u6587"), ",", wcstr});
+    CHECK(fileContains(logFile, "wide:\xE6\x96\x87,w\xE4\xB8\xAD,z"), "template path mismatch");
+    CHECK(fileContains(logFile, "wide_any:\xE6\x96\x87,w\xE4\xB8\xAD"), "std::any path mismatch");
+    PASS();
+}
+
+// 2.2) 静态调用点描述符：编译期 basename、首次输出时分配稠密 ID
+void test_log_site(const std::string& logFile) {
+    TEST("static call-site descriptor: basename prefix and dense ID");
+
+    const std::uint32_t before = Logger::logSiteCount();
+    static LogSite site{LoggerUtil::fileBasename(__FILE__), __LINE__, __FUNCTION__, LogLevel::Info};
+    CHECK(site.id.load() == 0, "site registered before first use");
+    CHECK(std::string(site.file) == "main.cpp", std::string("basename mismatch: ") + site.file);
+
+    for (int i = 0; i < 3; ++i) {
+        Logger::log(site, "site_msg_", i);
+    }
+    const std::uint32_t id = site.id.load();
+    CHECK(id != 0, "site id not assigned");
+    CHECK(Logger::logSiteCount() == before + 1, "site registered more than once");
+    CHECK(Logger::getLogSite(id) == &site, "getLogSite mismatch");
+    CHECK(Logger::getLogSite(0) == nullptr, "id 0 should be invalid");
+    CHECK(Logger::getLogSite(Logger::logSiteCount() + 1) == nullptr, "out-of-range id should be invalid");
+
+    LOG_WARN("site_macro_warn");
+    std::string content = readFile(logFile);
+    CHECK(content.find("[main.cpp:" + std::to_string(site.line) + "][test_log_site]site_msg_2") != std::string::npos,
+          "cached site prefix missing");
+    CHECK(content.find("[warning][main.cpp:") != std::string::npos, "macro prefix should use basename");
+    PASS();
+}
+
+// 2.3) 稳态零分配：模板接口与 std::any 接口拼接都使用线程局部缓冲
+void test_steady_state_allocs(const std::string& logFile) {
+    TEST("steady-state logging allocates nothing");
+
+    auto logOnce = [](int i) {
+        LOG_INFO("alloc_tpl:", i, ',', 0.25, ',', true, ',', std::string_view("sv"));
+        Logger::info(GET_LINE, {"alloc_any:", i, ",", 0.5, ",", false, ",", "cstr"});
+    };
+    for (int i = 0; i < 10; ++i) logOnce(i); // 预热：线程局部缓冲、调用点注册、分发表
+
+    t_allocCount = 0;
+    t_countAllocs = true;
+    for (int i = 0; i < 100; ++i) logOnce(i);
+    t_countAllocs = false;
+
+    CHECK(fileContains(logFile, "alloc_any:99,0.5,false,cstr"), "std::any path output mismatch");
+#ifndef _WIN32 // Windows 下 DLL 内的分配不经过可执行程序替换的 operator new
+    CHECK(t_allocCount == 0, "expected 0 allocations, got " + std::to_string(t_allocCount));
+#endif
+    PASS();
+}
+
 // 3) 回调 sink
 void test_callback() {
     TEST("callback sink");
@@ -211,6 +382,40 @@ void test_callback() {
     PASS();
 }
 
+// 3.1) 零拷贝视图回调
+void test_callback_view() {
+    TEST("callback with LogMsgView");
+
+    int calls = 0;
+    LogMsgView last;
+    std::string formatted;
+    std::string loggerName;
+    const std::string sinkId = Logger::addCallBack(
+        [&](const LogMsgView& view) {
+            ++calls;
+            last = view;
+            formatted.assign(view.msgFormatted());  // 视图只在回调内有效，需要保留的字段自行拷贝
+            CHECK(view.msgFormatted().data() == view.msgFormatted().data(), "msgFormatted not cached");
+            loggerName.assign(view.loggerName);
+            CHECK(view.toLogMsg().msg == std::string(view.msg), "toLogMsg msg mismatch");
+        },
+        LogLevel::Trace);
+
+    const auto before = std::chrono::system_clock::now();
+    LOG_WARN("callback_view_marker");
+    const auto after = std::chrono::system_clock::now();
+    Logger::removeCallBack(sinkId);
+
+    CHECK(calls == 1, "view callback calls: " + std::to_string(calls));
+    CHECK(last.level == LogLevel::Warn, "view level mismatch");
+    CHECK(last.threadId != 0, "view threadId empty");
+    CHECK(last.time >= before - std::chrono::milliseconds(1) && last.time <= after + std::chrono::milliseconds(1),
+          "view time out of range");
+    CHECK(formatted.find("callback_view_marker") != std::string::npos, "msgFormatted missing marker");
+    CHECK(loggerName == "test-sync", "view loggerName: " + loggerName);
+    PASS();
+}
+
 // 4) 异步日志 — 核心检测
 void test_async(const std::string& configPath, const std::string& asyncLogFile, const std::string& syncLogFile) {
     TEST("async logging: write " + std::to_string(500) + " messages, no data loss");
@@ -253,6 +458,518 @@ void test_async(const std::string& configPath, const std::string& asyncLogFile,
     PASS();
 }
 
+// 4.0.0) 异步线程的名称、CPU 亲和性与 nice 值在线程启动时生效（仅 Linux）
+void test_async_thread_tuning(const std::string& dir) {
+    TEST("async worker thread name / affinity / nice");
+#ifdef __linux__
+    const std::string configPath = dir + "tuning.yaml";
+    writeAsyncConfig(configPath, dir + "tuning.log");
+    {
+        std::ifstream in(configPath);
+        std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        const std::string anchor = "    async_thread_count: 1\n";
+        content.insert(content.find(anchor) + anchor.size(),
+                       "    async_thread_name: lgtest-async\n"
+                       "    async_cpu_affinity: \"0\"\n"
+                       "    async_nice: 5\n");
+        std::ofstream out(configPath);
+        out << content;
+    }
+
+    Logger::shutdown();
+    Logger::setConfigPath(configPath, false);
+
+    // 回调在异步 worker 上执行，在其中读取线程属性
+    std::mutex mutex;
+    std::string name;
+    int cpuCount = -1;
+    bool onCpu0 = false;
+    int niceValue = -100;
+    std::atomic<bool> seen{false};
+    const std::string id = Logger::addCallBack(
+        [&](const LogMsg&) {
+            if (seen.exchange(true)) return;
+            std::lock_guard<std::mutex> lock(mutex);
+            char buffer[16] = {};
+            pthread_getname_np(pthread_self(), buffer, sizeof(buffer));
+            name = buffer;
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+                cpuCount = CPU_COUNT(&set);
+                onCpu0 = CPU_ISSET(0, &set);
+            }
+            errno = 0;
+            niceValue = getpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)));
+        },
+        LogLevel::Trace);
+    LOG_INFO("TUNING_PROBE");
+    for (int i = 0; i < 500 && !seen.load(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    Logger::removeCallBack(id);
+    Logger::shutdown();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK(seen.load(), "callback not invoked on the async worker");
+    CHECK(name == "lgtest-async", "thread name: " + name);
+    CHECK(cpuCount == 1 && onCpu0, "affinity: " + std::to_string(cpuCount) + " cpus");
+    CHECK(niceValue == 5, "nice: " + std::to_string(niceValue));
+#endif
+    PASS();
+}
+
+// 4.0.1) sink 级异步：独立队列与具名线程池，输出与同步 sink 逐行一致，统计正确
+void test_async_sink(const std::string& dir) {
+    TEST("per-sink async: own queue and named pool match the sync sink");
+
+    const std::string configPath = dir + "sink_async.yaml";
+    const std::string syncLog = dir + "sink_sync.log";
+    const std::string ownLog = dir + "sink_own.log";
+    const std::string pooledLog = dir + "sink_pooled.log";
+    {
+        std::ofstream f(configPath);
+        f << "log_config:\n"
+          << "  logger:\n"
+          << "    name: test-sink-async\n"
+          << "    debug_level: trace\n"
+          << "    release_level: trace\n"
+          << "    flush_on: trace\n"
+          << "    pattern: \"%n|%t|%v\"\n"
+          << "  thread_pools:\n"
+          << "    - name: slow_io\n"
+          << "      queue_size: 1024\n"
+          << "      thread_count: 1\n"
+          << "  sinks:\n"
+          << "    - type: basic_file_sink_mt\n"
+          << "      level: trace\n"
+          << "      file_path: " << syncLog << "\n"
+          << "      truncate: true\n"
+          << "    - type: basic_file_sink_mt\n"
+          << "      level: trace\n"
+          << "      file_path: " << ownLog << "\n"
+          << "      truncate: true\n"
+          << "      async: true\n"
+          << "      async_queue_size: 256\n"
+          << "    - type: basic_file_sink_mt\n"
+          << "      level: info\n"
+          << "      file_path: " << pooledLog << "\n"
+          << "      truncate: true\n"
+          << "      async: true\n"
+          << "      thread_pool: slow_io\n";
+    }
+
+    Logger::shutdown();
+    Logger::setConfigPath(configPath, false);
+
+    const int N = 300;
+    for (int i = 0; i < N; ++i) {
+        LOG_INFO("SINK_ASYNC_", i);
+        LOG_DEBUG("SINK_ASYNC_DEBUG_", i);
+    }
+
+    const std::vector<AsyncSinkStats> stats = Logger::asyncSinkStats();
+    CHECK(stats.size() == 2, "expected 2 async sinks, got " + std::to_string(stats.size()));
+    CHECK(stats[0].sink == "basic_file_sink_mt#1" && stats[0].pool.empty() && stats[0].queueCapacity == 256,
+          "own-queue sink stats wrong: " + stats[0].sink);
+    CHECK(stats[1].sink == "basic_file_sink_mt#2" && stats[1].pool == "slow_io" && stats[1].queueCapacity == 1024,
+          "pooled sink stats wrong: " + stats[1].sink + " / " + stats[1].pool);
+    // 低于 sink 级别的日志在入队前过滤
+    CHECK(stats[0].enqueued == 2 * N && stats[1].enqueued == N,
+          "enqueued " + std::to_string(stats[0].enqueued) + " / " + std::to_string(stats[1].enqueued));
+    CHECK(stats[0].written <= stats[0].enqueued && stats[0].stallMax <= stats[0].stallTotal, "stall stats inconsistent");
+    Logger::shutdown();
+    CHECK(Logger::asyncSinkStats().empty(), "async sink stats survive shutdown");
+
+    // 线程 id、logger 名称、顺序与同步 sink 完全一致
+    const std::string syncContent = readFile(syncLog);
+    CHECK(countLines(syncLog) == 2 * N, "sync sink lines: " + std::to_string(countLines(syncLog)));
+    CHECK(readFile(ownLog) == syncContent, "own-queue sink output differs from sync sink");
+    std::string infoOnly;
+    {
+        std::istringstream in(syncContent);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.find("DEBUG") == std::string::npos) infoOnly += line + "\n";
+        }
+    }
+    CHECK(readFile(pooledLog) == infoOnly, "pooled sink output differs from sync sink");
+    PASS();
+}
+
+// 4.0.2) 异步队列满时按 async_overflow_policy 处理，丢弃/覆盖计数与实际丢失条数一致
+void test_async_overflow(const std::string& dir) {
+    TEST("async overflow policy: discard_new / overrun_oldest accounting");
+
+    for (const std::string policy : {"discard_new", "overrun_oldest"}) {
+        const std::string configPath = dir + "overflow_" + policy + ".yaml";
+        const std::string logFile = dir + "overflow_" + policy + ".log";
+        const int CAPACITY = 16;
+        writeAsyncConfig(configPath, logFile, CAPACITY, policy);
+
+        Logger::shutdown();
+        Logger::setConfigPath(configPath, false);
+
+        // 回调在写线程上执行：收到第一条后挂起写线程，使队列确定地写满
+        std::atomic<bool> blocked{false};
+        std::atomic<bool> release{false};
+        const std::string id = Logger::addCallBack(
+            [&](const LogMsg&) {
+                if (!blocked.exchange(true)) {
+                    while (!release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            },
+            LogLevel::Trace);
+
+        const int N = 200;
+        LOG_INFO("OVF_0");
+        for (int i = 0; i < 500 && !blocked.load(); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        CHECK(blocked.load(), "worker did not pick up the first message");
+        for (int i = 1; i < N; ++i) {
+            LOG_INFO("OVF_", i);
+        }
+
+        const AsyncStats stats = Logger::asyncStats();
+        CHECK(stats.enabled && stats.queueCapacity == CAPACITY, policy + ": queue capacity not reported");
+        CHECK(stats.queueDepth == CAPACITY, policy + ": queue depth " + std::to_string(stats.queueDepth));
+        const std::uint64_t lost = policy == "discard_new" ? stats.discardCount : stats.overrunCount;
+        CHECK(lost == N - 1 - CAPACITY, policy + ": lost count " + std::to_string(lost));
+        CHECK((policy == "discard_new" ? stats.overrunCount : stats.discardCount) == 0, policy + ": wrong counter used");
+
+        release.store(true);
+        Logger::removeCallBack(id);
+        Logger::shutdown();
+        CHECK(!Logger::asyncStats().enabled, "stats still report an async queue after shutdown");
+
+        CHECK(countLines(logFile) == N - static_cast<int>(lost),
+              policy + ": " + std::to_string(countLines(logFile)) + " lines written");
+        // discard_new 保留最早的日志，overrun_oldest 保留最新的日志
+        const std::string kept = policy == "discard_new" ? "OVF_16\n" : "OVF_199\n";
+        const std::string gone = policy == "discard_new" ? "OVF_199\n" : "OVF_16\n";
+        CHECK(fileContains(logFile, kept), policy + ": expected " + kept);
+        CHECK(!fileContains(logFile, gone), policy + ": unexpected " + gone);
+    }
+    PASS();
+}
+
+// 4.0) 按线程分队列：各线程的日志按时间戳归并写出，每个线程的队列单独计容量
+void test_async_per_thread(const std::string& dir) {
+    TEST("async per_thread queue: timestamp merge, per-thread capacity, discard accounting");
+
+    const std::string configPath = dir + "per_thread.yaml";
+    const std::string logFile = dir + "per_thread.log";
+    const int CAPACITY = 16;
+    writeAsyncConfig(configPath, logFile, CAPACITY, "discard_new", "per_thread");
+
+    Logger::shutdown();
+    Logger::setConfigPath(configPath, false);
+
+    // 回调在 worker 上执行：收到第一条后挂起 worker，之后的日志都留在各线程的队列中
+    std::atomic<bool> blocked{false};
+    std::atomic<bool> release{false};
+    const std::string id = Logger::addCallBack(
+        [&](const LogMsg&) {
+            if (!blocked.exchange(true)) {
+                while (!release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        },
+        LogLevel::Trace);
+
+    LOG_INFO("PT_FIRST");
+    for (int i = 0; i < 500 && !blocked.load(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    CHECK(blocked.load(), "worker did not pick up the first message");
+
+    // 两个线程交替打日志，各自的日志进入各自的队列
+    const int TURNS = 10;
+    std::atomic<int> turn{0};
+    auto alternate = [&](int self) {
+        for (;;) {
+            const int current = turn.load();
+            if (current >= TURNS) break;
+            if (current % 2 != self) {
+                std::this_thread::yield();
+                continue;
+            }
+            LOG_INFO("PT_MERGE_", current, "_");
+            turn.store(current + 1);
+        }
+    };
+    std::thread first(alternate, 0);
+    std::thread second(alternate, 1);
+    first.join();
+    second.join();
+
+    // 第三个线程写满自己的队列，超出的部分被丢弃，不影响其他线程
+    const int BURST = 30;
+    std::thread burst([&] {
+        for (int i = 0; i < BURST; ++i) LOG_INFO("PT_BURST_", i, "_");
+    });
+    burst.join();
+
+    const AsyncStats stats = Logger::asyncStats();
+    CHECK(stats.enabled && stats.perThreadQueue, "per_thread queue not reported");
+    CHECK(stats.queueCapacity == CAPACITY, "per-thread capacity " + std::to_string(stats.queueCapacity));
+    CHECK(stats.producerQueues == 4, "producer queues " + std::to_string(stats.producerQueues));
+    CHECK(stats.queueDepth == 1 + TURNS + CAPACITY, "queue depth " + std::to_string(stats.queueDepth));
+    CHECK(stats.discardCount == BURST - CAPACITY, "discard count " + std::to_string(stats.discardCount));
+
+    release.store(true);
+    Logger::removeCallBack(id);
+    Logger::shutdown();
+    CHECK(!Logger::asyncStats().enabled, "stats still report an async queue after shutdown");
+
+    CHECK(countLines(logFile) == 1 + TURNS + CAPACITY, std::to_string(countLines(logFile)) + " lines written");
+    const std::string content = readFile(logFile);
+    std::size_t last = content.find("PT_FIRST");
+    CHECK(last != std::string::npos, "missing PT_FIRST");
+    for (int i = 0; i < TURNS; ++i) {
+        const std::size_t pos = content.find("PT_MERGE_" + std::to_string(i) + "_");
+        CHECK(pos != std::string::npos && pos > last, "PT_MERGE_" + std::to_string(i) + " out of timestamp order");
+        last = pos;
+    }
+    CHECK(content.find("PT_BURST_0_") > last, "burst written before earlier messages");
+    CHECK(fileContains(logFile, "PT_BURST_15_"), "expected PT_BURST_15");
+    CHECK(!fileContains(logFile, "PT_BURST_16_"), "unexpected PT_BURST_16");
+    PASS();
+}
+
+// 4.0.1) per_thread worker 批量写入：积压的日志整批写出，按行数滚动的文件在批内正确滚动
+void test_async_batch(const std::string& dir) {
+    TEST("async batch writes: backlog written in batches, count rotation inside a batch");
+
+    const std::string configPath = dir + "batch.yaml";
+    const std::string basicFile = dir + "batch_basic.log";
+    const std::string rotatingStem = dir + "batch_count";
+    std::filesystem::remove(basicFile);
+    std::filesystem::remove(rotatingStem + ".log");
+    for (int index = 1; index <= 5; ++index) {
+        std::filesystem::remove(rotatingStem + "." + std::to_string(index) + ".log");
+    }
+    {
+        std::ofstream f(configPath);
+        f << "log_config:\n"
+          << "  logger:\n"
+          << "    name: test-batch\n"
+          << "    debug_level: trace\n"
+          << "    release_level: trace\n"
+          << "    flush_on: trace\n"
+          << "    pattern: \"[%l]%v\"\n"
+          << "    async: true\n"
+          << "    async_queue: per_thread\n"
+          << "    async_queue_size: 1024\n"
+          << "    async_batch_size: 64\n"
+          << "  showCodeLine:\n"
+          << "    trace: false\n    debug: false\n    info: false\n"
+          << "    warn: false\n    error: false\n    critical: false\n"
+          << "  sinks:\n"
+          << "    - type: basic_file_sink_mt\n"
+          << "      level: trace\n"
+          << "      file_path: " << basicFile << "\n"
+          << "      truncate: true\n"
+          << "    - type: count_rotating_file_mt\n"
+          << "      level: trace\n"
+          << "      file_path: " << rotatingStem << ".log\n"
+          << "      max_count: 40\n"
+          << "      max_files: 5\n";
+    }
+
+    Logger::shutdown();
+    Logger::setConfigPath(configPath, false);
+
+    std::atomic<bool> blocked{false};
+    std::atomic<bool> release{false};
+    const std::string id = Logger::addCallBack(
+        [&](const LogMsg&) {
+            if (!blocked.exchange(true)) {
+                while (!release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        },
+        LogLevel::Trace);
+
+    LOG_INFO("BATCH_0");
+    for (int i = 0; i < 500 && !blocked.load(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    CHECK(blocked.load(), "worker did not pick up the first message");
+    const int N = 200;
+    for (int i = 1; i < N; ++i) {
+        LOG_INFO("BATCH_", i);
+    }
+    release.store(true);
+    for (int i = 0; i < 500 && Logger::asyncStats().queueDepth > 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    const AsyncStats stats = Logger::asyncStats();
+    CHECK(stats.queueDepth == 0, "backlog not drained");
+    // 第一条单独一批，积压的 199 条按每批 64 条写出
+    CHECK(stats.batchCount >= 5 && stats.batchCount < 20, "batch count " + std::to_string(stats.batchCount));
+
+    Logger::removeCallBack(id);
+    Logger::shutdown();
+
+    CHECK(countLines(basicFile) == N, "basic file has " + std::to_string(countLines(basicFile)) + " lines");
+    const std::string content = readFile(basicFile);
+    std::size_t last = 0;
+    for (int i = 0; i < N; ++i) {
+        const std::size_t pos = content.find("BATCH_" + std::to_string(i) + "\n");
+        CHECK(pos != std::string::npos && (i == 0 || pos > last), "BATCH_" + std::to_string(i) + " missing or out of order");
+        last = pos;
+    }
+
+    // 200 条、每个文件 40 条：写满第 40 条即滚动，最后留下 5 个备份，当前文件尚未创建
+    std::string rotated;
+    for (int index = 5; index >= 1; --index) {
+        const std::string file = rotatingStem + "." + std::to_string(index) + ".log";
+        CHECK(countLines(file) == 40, file + " has " + std::to_string(countLines(file)) + " lines");
+        rotated += readFile(file);
+    }
+    CHECK(!std::filesystem::exists(rotatingStem + ".log"), "current file created without pending messages");
+    CHECK(rotated == content, "rotated files differ from the basic file");
+    PASS();
+}
+
+// 4.1) 异步延迟格式化：记录在 worker 上解码，输出与即时格式化完全一致
+void test_async_deferred(const std::string& configPath, const std::string& logFile) {
+    TEST("async deferred format: records decoded on worker match eager output");
+
+    Logger::shutdown();
+    {
+        std::ofstream f(configPath);
+        f << "log_config:\n"
+          << "  logger:\n"
+          << "    name: test-deferred\n"
+          << "    debug_level: trace\n"
+          << "    release_level: trace\n"
+          << "    flush_on: trace\n"
+          << "    pattern: \"[%l]%v\"\n"
+          << "    async: true\n"
+          << "    async_deferred_format: true\n"
+          << "    async_queue_size: 8192\n"
+          << "    async_thread_count: 1\n"
+          << "  showCodeLine:\n"
+          << "    trace: false\n    debug: false\n    info: false\n"
+          << "    warn: true\n    error: true\n    critical: true\n"
+          << "  sinks:\n"
+          << "    - type: basic_file_sink_mt\n"
+          << "      level: trace\n"
+          << "      file_path: " << logFile << "\n"
+          << "      truncate: true\n";
+    }
+    Logger::setConfigPath(configPath, false);
+
+    const int N = 300;
+    for (int i = 0; i < N; ++i) {
+        LOG_INFO("DEFER_", i, " f=", 0.5f, " d=", 2.25, " b=", true, " s=", std::string("abc"), " w=", L"wide", " c=", 'x', " wc=", L'z');
+    }
+    LOG_WARN("DEFER_WARN");
+#if defined(__SIZEOF_INT128__) && !defined(__STRICT_ANSI__) // 超过 64 位的整数不进入记录，退回即时格式化
+    LOG_INFO("DEFER_I128_", ~static_cast<unsigned __int128>(0));
+#endif
+    const std::string longText(2000, 'L'); // 超出定长记录容量，退回即时格式化
+    LOG_INFO("DEFER_LONG_", longText);
+    Logger::shutdown();
+
+    std::string expectedTail;
+    LoggerUtil::appendArg(expectedTail, " f=");
+    LoggerUtil::appendArg(expectedTail, 0.5f);
+    LoggerUtil::appendArg(expectedTail, " d=");
+    LoggerUtil::appendArg(expectedTail, 2.25);
+    expectedTail += " b=true s=abc w=wide c=x wc=z";
+
+    std::set<int> found;
+    bool warnHasLine = false;
+    bool longFound = false;
+    bool i128Found = false;
+    {
+        std::ifstream f(logFile);
+        std::string line;
+        while (std::getline(f, line)) {
+            if (line.find("DEFER_WARN") != std::string::npos) {
+                warnHasLine = line.find("main.cpp") != std::string::npos;
+                continue;
+            }
+            if (line.find("DEFER_I128_") != std::string::npos) {
+                i128Found = line.find("DEFER_I128_340282366920938463463374607431768211455") != std::string::npos;
+                continue;
+            }
+            if (line.find("DEFER_LONG_" + longText) != std::string::npos) {
+                longFound = true;
+                continue;
+            }
+            auto pos = line.find("[info]DEFER_");
+            if (pos == std::string::npos) continue;
+            std::size_t idxEnd = 0;
+            int idx = std::stoi(line.substr(pos + 12), &idxEnd);
+            CHECK(line.substr(pos + 12 + idxEnd) == expectedTail, "decoded text mismatch: " + line);
+            found.insert(idx);
+        }
+    }
+    CHECK(static_cast<int>(found.size()) == N, "expected " + std::to_string(N) + " records, got " + std::to_string(found.size()));
+    CHECK(warnHasLine, "showCodeLine prefix missing in deferred mode");
+    CHECK(longFound, "oversized message lost");
+#if defined(__SIZEOF_INT128__) && !defined(__STRICT_ANSI__)
+    CHECK(i128Found, "__int128 truncated in deferred mode");
+#endif
+    PASS();
+}
+
+// 4.2) 二进制日志文件：与文本 sink 同时输出，文本不受影响，二进制文件明显更小
+void test_binary_file(const std::string& configPath, const std::string& binFile, const std::string& textFile) {
+    TEST("binary_file_mt: compact records alongside text sink");
+
+    Logger::shutdown();
+    {
+        std::ofstream f(configPath);
+        f << "log_config:\n"
+          << "  logger:\n"
+          << "    name: test-binary\n"
+          << "    debug_level: trace\n"
+          << "    release_level: trace\n"
+          << "    flush_on: trace\n"
+          << "    pattern: \"[%Y-%m-%d %H:%M:%S.%e][%n][%l][thread %t]%v\"\n"
+          << "    async: false\n"
+          << "  showCodeLine:\n"
+          << "    trace: true\n    debug: true\n    info: true\n"
+          << "    warn: true\n    error: true\n    critical: true\n"
+          << "  sinks:\n"
+          << "    - type: binary_file_mt\n"
+          << "      level: trace\n"
+          << "      file_path: " << binFile << "\n"
+          << "      truncate: true\n"
+          << "    - type: basic_file_sink_mt\n"
+          << "      level: trace\n"
+          << "      file_path: " << textFile << "\n"
+          << "      truncate: true\n";
+    }
+    Logger::setConfigPath(configPath, false);
+
+    const int N = 1000;
+    for (int i = 0; i < N; ++i) {
+        LOG_INFO("BIN_MSG_", i, " value=", i * 0.5, " ok=", true);
+    }
+    Logger::info(GET_LINE, {"BIN_ANY_", 1});
+    Logger::shutdown();
+
+    std::string text = readFile(textFile);
+    CHECK(text.find("BIN_MSG_999 value=499.5 ok=true") != std::string::npos, "text sink output mismatch");
+    CHECK(text.find("main.cpp") != std::string::npos, "showCodeLine prefix missing");
+    CHECK(text.find("BIN_ANY_1") != std::string::npos, "std::any message missing");
+    CHECK(countLines(textFile) == N + 1, "text sink line count mismatch");
+
+    std::ifstream bin(binFile, std::ios::binary);
+    char magic[4] = {};
+    bin.read(magic, 4);
+    CHECK(std::string(magic, 4) == "LGRB", "binary segment header missing");
+    auto binSize = fs::file_size(binFile);
+    auto textSize = fs::file_size(textFile);
+    CHECK(binSize * 3 < textSize, "binary file not compact: " + std::to_string(binSize) + " vs " + std::to_string(textSize));
+    PASS();
+}
+
 // 5) 多线程并发日志
 void test_multithread(const std::string& configPath, const std::string& logFile) {
     TEST("multithread: 4 threads x 250 messages each");
@@ -302,6 +1019,372 @@ void test_multithread(const std::string& configPath, const std::string& logFile)
     PASS();
 }
 
+// 5.1) 多线程打日志的同时反复切换配置（同步 <-> 异步）：不崩溃、不丢日志
+void test_hot_swap(const std::string& dir) {
+    TEST("config swap under concurrent logging: no crash, no lost messages");
+
+    const std::string syncConfig = dir + "swap_sync.yaml";
+    const std::string asyncConfig = dir + "swap_async.yaml";
+    const std::string syncLog = dir + "swap_sync.log";
+    const std::string asyncLog = dir + "swap_async.log";
+    auto writeConfig = [](const std::string& path, const std::string& logFile, bool async) {
+        std::ofstream f(path);
+        f << "log_config:\n"
+          << "  logger:\n"
+          << "    name: test-swap\n"
+          << "    debug_level: trace\n"
+          << "    release_level: trace\n"
+          << "    flush_on: trace\n"
+          << "    pattern: \"%v\"\n"
+          << "    async: " << (async ? "true" : "false") << "\n"
+          << "  showCodeLine:\n"
+          << "    trace: false\n    debug: false\n    info: false\n"
+          << "    warn: false\n    error: false\n    critical: false\n"
+          << "  sinks:\n"
+          << "    - type: basic_file_sink_mt\n"
+          << "      level: trace\n"
+          << "      file_path: " << logFile << "\n"
+          << "      truncate: false\n";
+    };
+    writeConfig(syncConfig, syncLog, false);
+    writeConfig(asyncConfig, asyncLog, true);
+
+    Logger::shutdown();
+    Logger::setConfigPath(syncConfig, false);
+
+    const int THREADS = 4;
+    const int PER_THREAD = 2000;
+    std::atomic<int> done{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < PER_THREAD; ++i) {
+                LOG_INFO("SWAP_", t, "_", i);
+                if (i % 64 == 0) std::this_thread::yield();
+            }
+            done.fetch_add(1);
+        });
+    }
+    int swaps = 0;
+    while (done.load() < THREADS) {
+        Logger::setConfigPath(swaps % 2 == 0 ? asyncConfig : syncConfig, false);
+        ++swaps;
+    }
+    for (auto& th : threads) th.join();
+    Logger::shutdown();
+
+    const int total = countLines(syncLog) + countLines(asyncLog);
+    CHECK(swaps > 0, "no swap happened");
+    CHECK(total == THREADS * PER_THREAD,
+          "expected " + std::to_string(THREADS * PER_THREAD) + " lines, got " + std::to_string(total) +
+          " (swaps: " + std::to_string(swaps) + ")");
+    PASS();
+}
+
+// 5.1.1) 在异步 worker 线程上的回调中切换配置：切换立即返回，旧管线在后台排空，不死锁、不丢日志
+void test_swap_in_callback(const std::string& dir) {
+    TEST("config swap from an async callback: old pipeline drains in background");
+
+    const std::string asyncConfig = dir + "cbswap_async.yaml";
+    const std::string syncConfig = dir + "cbswap_sync.yaml";
+    const std::string asyncLog = dir + "cbswap_async.log";
+    const std::string syncLog = dir + "cbswap_sync.log";
+    auto writeConfig = [](const std::string& path, const std::string& logFile, bool async) {
+        std::ofstream f(path);
+        f << "log_config:\n"
+          << "  logger:\n"
+          << "    name: test-cbswap\n"
+          << "    debug_level: trace\n"
+          << "    release_level: trace\n"
+          << "    flush_on: trace\n"
+          << "    pattern: \"%v\"\n"
+          << "    async: " << (async ? "true" : "false") << "\n"
+          << "  sinks:\n"
+          << "    - type: basic_file_sink_mt\n"
+          << "      level: trace\n"
+          << "      file_path: " << logFile << "\n";
+    };
+    writeConfig(asyncConfig, asyncLog, true);
+    writeConfig(syncConfig, syncLog, false);
+
+    Logger::shutdown();
+    Logger::setConfigPath(asyncConfig, false);
+
+    std::atomic<bool> swapped{false};
+    const std::string id = Logger::addCallBack(
+        [&](const LogMsg& msg) {
+            if (!swapped.load() && msg.msg.find("CBSWAP_TRIGGER") != std::string::npos) {
+                Logger::setConfigPath(syncConfig, false);
+                swapped.store(true);
+            }
+        },
+        LogLevel::Trace);
+
+    const int BEFORE = 500;
+    for (int i = 0; i < BEFORE; ++i) {
+        LOG_INFO("CBSWAP_BEFORE_", i);
+    }
+    LOG_INFO("CBSWAP_TRIGGER");
+    for (int i = 0; i < 500 && !swapped.load(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(swapped.load(), "swap inside callback did not complete");
+    LOG_INFO("CBSWAP_AFTER");
+    Logger::removeCallBack(id);
+    Logger::shutdown();
+
+    CHECK(countLines(asyncLog) == BEFORE + 1, "old async pipeline lost lines: " + std::to_string(countLines(asyncLog)));
+    CHECK(fileContains(syncLog, "CBSWAP_AFTER"), "new config did not receive messages");
+    CHECK(!fileContains(asyncLog, "CBSWAP_AFTER"), "message logged after swap went to the old pipeline");
+    PASS();
+}
+
+// 5.1b) 异步队列未排空时 shutdown：排空期间回调调用控制接口（需要控制锁）不会死锁，回调照常收完
+void test_shutdown_in_callback(const std::string& dir) {
+    TEST("shutdown with a non-empty async queue: callbacks may call control APIs");
+
+    const std::string config = dir + "cbshutdown.yaml";
+    {
+        std::ofstream f(config);
+        f << "log_config:\n"
+          << "  logger:\n"
+          << "    name: test-cbshutdown\n"
+          << "    debug_level: trace\n"
+          << "    release_level: trace\n"
+          << "    flush_on: off\n"
+          << "    pattern: \"%v\"\n"
+          << "    async: true\n"
+          << "  sinks:\n"
+          << "    - type: \"null\"\n"
+          << "      level: trace\n";
+    }
+
+    Logger::shutdown();
+    Logger::setConfigPath(config, false);
+
+    const int N = 2000;
+    std::atomic<int> received{0};
+    std::atomic<int> dropQueried{0};
+    Logger::addCallBack(
+        [&](const LogMsg&) {
+            Logger::asyncStats();
+            if (Logger::callBackDropCount("no-such-sink") == 0)
+                dropQueried.fetch_add(1);
+            Logger::configReloadStats();
+            received.fetch_add(1);
+        },
+        LogLevel::Trace);
+
+    for (int i = 0; i < N; ++i) {
+        LOG_INFO("CBSHUTDOWN_", i);
+    }
+
+    // 在另一个线程上 shutdown，死锁时不拖住整个测试进程
+    std::atomic<bool> done{false};
+    std::thread closer([&] {
+        Logger::shutdown();
+        done.store(true);
+    });
+    for (int i = 0; i < 2000 && !done.load(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (!done.load()) {
+        FAIL("shutdown did not return within 20s");
+        std::cout.flush();
+        std::_Exit(1);
+    }
+    closer.join();
+
+    CHECK(received.load() == N, "callback lost messages during shutdown: " + std::to_string(received.load()));
+    CHECK(dropQueried.load() == N, "control API returned unexpected values inside the callback");
+    PASS();
+}
+
+// 5.2) 多线程打日志的同时反复增删回调：不崩溃，常驻回调不漏收，回调中可移除自身
+void test_callback_churn(const std::string& configPath) {
+    TEST("callback add/remove under concurrent logging");
+
+    Logger::shutdown();
+    Logger::setConfigPath(configPath, false);
+
+    std::atomic<int> persistent{0};
+    const std::string persistentId = Logger::addCallBack(
+        [&](const LogMsg& msg) {
+            if (msg.msg.find("CHURN_") != std::string::npos) ++persistent;
+        },
+        LogLevel::Trace);
+
+    // 首次收到日志时在回调内移除自己
+    std::atomic<int> oneShot{0};
+    auto oneShotId = std::make_shared<std::string>();
+    std::mutex oneShotMutex;
+    {
+        std::lock_guard<std::mutex> lock(oneShotMutex);
+        *oneShotId = Logger::addCallBack(
+            [&, oneShotId](const LogMsg&) {
+                if (oneShot.fetch_add(1) == 0) {
+                    std::lock_guard<std::mutex> lock(oneShotMutex);
+                    Logger::removeCallBack(*oneShotId);
+                }
+            },
+            LogLevel::Trace);
+    }
+
+    const int THREADS = 4;
+    const int PER_THREAD = 2000;
+    std::atomic<int> done{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < PER_THREAD; ++i) {
+                LOG_INFO("CHURN_", t, "_", i);
+                if (i % 64 == 0) std::this_thread::yield();
+            }
+            done.fetch_add(1);
+        });
+    }
+    int churns = 0;
+    std::atomic<int> transient{0};
+    while (done.load() < THREADS && churns < 200) {
+        const std::string id = Logger::addCallBack([&](const LogMsg&) { ++transient; }, LogLevel::Trace);
+        std::this_thread::yield();
+        Logger::removeCallBack(id);
+        ++churns;
+    }
+    for (auto& th : threads) th.join();
+
+    // 移除返回后回调不应再被调用
+    const int transientAfter = transient.load();
+    LOG_INFO("after_churn");
+    Logger::removeCallBack(persistentId);
+
+    CHECK(churns > 0, "no callback churn happened");
+    CHECK(persistent.load() == THREADS * PER_THREAD,
+          "persistent callback expected " + std::to_string(THREADS * PER_THREAD) + ", got " +
+          std::to_string(persistent.load()));
+    CHECK(transient.load() == transientAfter, "removed callback fired after removal");
+    CHECK(oneShot.load() >= 1, "one-shot callback never fired");
+    const int oneShotAfter = oneShot.load();
+    LOG_INFO("after_one_shot");
+    CHECK(oneShot.load() == oneShotAfter, "self-removed callback still fired");
+    PASS();
+}
+
+// 5.3) 异步回调：慢回调不阻塞打日志的线程，队列满按策略丢弃并计数，移除时投递完剩余日志
+void test_async_callback(const std::string& configPath) {
+    TEST("async callback dispatcher: overflow policies and drop counter");
+
+    Logger::shutdown();
+    Logger::setConfigPath(configPath, false);
+
+    const int COUNT = 200;
+    std::atomic<int> received{0};
+    CallbackOptions dropOptions;
+    dropOptions.mode = CallbackMode::Async;
+    dropOptions.queueSize = 16;
+    dropOptions.overflow = CallbackOverflow::DropNewest;
+    const std::string dropId = Logger::addCallBack(
+        [&](const LogMsg& msg) {
+            if (msg.msg.find("ASYNC_CB_") == std::string::npos) return;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            ++received;
+        },
+        LogLevel::Trace, dropOptions);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < COUNT; ++i) {
+        LOG_INFO("ASYNC_CB_", i);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const std::uint64_t dropped = Logger::callBackDropCount(dropId);
+    Logger::removeCallBack(dropId);
+
+    CHECK(elapsed < std::chrono::milliseconds(COUNT / 2), "logging thread was blocked by the slow callback");
+    CHECK(dropped > 0, "expected drops with a 16-entry queue");
+    CHECK(received.load() + static_cast<int>(dropped) == COUNT,
+          "received " + std::to_string(received.load()) + " + dropped " + std::to_string(dropped) +
+          " != " + std::to_string(COUNT));
+    CHECK(Logger::callBackDropCount(dropId) == 0, "removed callback still reports drops");
+
+    // 阻塞策略：不丢日志，且按顺序投递
+    std::vector<int> order;
+    CallbackOptions blockOptions;
+    blockOptions.mode = CallbackMode::Async;
+    blockOptions.queueSize = 8;
+    blockOptions.overflow = CallbackOverflow::Block;
+    const std::string blockId = Logger::addCallBack(
+        [&](const LogMsg& msg) {
+            const auto pos = msg.msg.find("ASYNC_BLOCK_");
+            if (pos == std::string::npos) return;
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            order.push_back(std::stoi(msg.msg.substr(pos + 12)));
+        },
+        LogLevel::Trace, blockOptions);
+    for (int i = 0; i < COUNT; ++i) {
+        LOG_INFO("ASYNC_BLOCK_", i);
+    }
+    const std::uint64_t blockDropped = Logger::callBackDropCount(blockId);
+    Logger::removeCallBack(blockId);
+
+    CHECK(blockDropped == 0, "block policy dropped " + std::to_string(blockDropped));
+    CHECK(static_cast<int>(order.size()) == COUNT, "block policy delivered " + std::to_string(order.size()));
+    for (int i = 0; i < COUNT; ++i) {
+        CHECK(order[i] == i, "out of order delivery at " + std::to_string(i));
+    }
+    PASS();
+}
+
+// 5.4) 批量回调：按条数或延时攒批，批内有序，移除时投递完剩余日志
+void test_batch_callback(const std::string& configPath) {
+    TEST("batch callback: size/delay coalescing");
+
+    Logger::shutdown();
+    Logger::setConfigPath(configPath, false);
+
+    std::mutex mutex;
+    std::vector<std::size_t> batchSizes;
+    std::vector<int> order;
+    bool formattedOk = true;
+    const std::string batchId = Logger::addBatchCallBack(
+        [&](const LogMsgBatch& batch) {
+            std::lock_guard<std::mutex> lock(mutex);
+            batchSizes.push_back(batch.size);
+            for (const LogMsgView& view : batch) {
+                const auto pos = view.msg.find("BATCH_");
+                if (pos == std::string_view::npos) continue;
+                order.push_back(std::stoi(std::string(view.msg.substr(pos + 6))));
+                formattedOk = formattedOk && view.msgFormatted().find(view.msg) != std::string_view::npos;
+            }
+        },
+        LogLevel::Trace, 64, std::chrono::milliseconds(20));
+
+    const int COUNT = 1000;
+    for (int i = 0; i < COUNT; ++i) {
+        LOG_INFO("BATCH_", i);
+    }
+    // 不足一批的日志在延时到达后投递
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    std::size_t delivered = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        delivered = order.size();
+    }
+    const std::uint64_t dropped = Logger::callBackDropCount(batchId);
+    Logger::removeCallBack(batchId);
+
+    CHECK(dropped == 0, "batch callback dropped " + std::to_string(dropped));
+    CHECK(delivered == COUNT, "delivered before removal: " + std::to_string(delivered));
+    CHECK(batchSizes.size() < static_cast<std::size_t>(COUNT), "messages were not coalesced");
+    for (std::size_t size : batchSizes) {
+        CHECK(size >= 1 && size <= 64, "batch size out of range: " + std::to_string(size));
+    }
+    for (int i = 0; i < COUNT; ++i) {
+        CHECK(order[i] == i, "out of order at " + std::to_string(i));
+    }
+    CHECK(formattedOk, "msgFormatted does not contain msg");
+    PASS();
+}
+
 // 6) 级别过滤
 void test_level_filter(const std::string& configPath, const std::string& logFile) {
     TEST("level filter: INFO level should block TRACE/DEBUG");
@@ -348,6 +1431,208 @@ void test_level_filter(const std::string& configPath, const std::string& logFile
     PASS();
 }
 
+// 6.1) 宏级别门限：被过滤的日志不求值参数
+void test_level_gate() {
+    TEST("level gate: filtered macros skip argument evaluation");
+
+    // 沿用 test_level_filter 的 info 级别配置
+    CHECK(!Logger::shouldLog(LogLevel::Trace), "shouldLog(Trace) should be false");
+    CHECK(!Logger::shouldLog(LogLevel::Debug), "shouldLog(Debug) should be false");
+    CHECK(Logger::shouldLog(LogLevel::Info), "shouldLog(Info) should be true");
+    CHECK(Logger::shouldLog(LogLevel::Critical), "shouldLog(Critical) should be true");
+
+    int evaluated = 0;
+    auto sideEffect = [&evaluated]() { ++evaluated; return evaluated; };
+    LOG_TRACE("gate_trace:", sideEffect());
+    LOG_DEBUG("gate_debug:", sideEffect());
+    CHECK(evaluated == 0, "filtered macro evaluated its arguments");
+    LOG_INFO("gate_info:", sideEffect());
+    CHECK(evaluated == 1, "enabled macro did not evaluate its arguments");
+    PASS();
+}
+
+// 6.2) 配置文件监视：修改后自动重新加载，写错的配置不替换正在工作的配置
+void test_config_watch(const std::string& dir) {
+    TEST("config watch: reload on change, keep working config on error");
+
+    const std::string configPath = dir + "watch.yaml";
+    const std::string logFile = dir + "watch.log";
+    auto writeConfig = [&](const std::string& path, const std::string& level) {
+        std::ofstream f(path);
+        f << "log_config:\n"
+          << "  logger:\n"
+          << "    name: test-watch\n"
+          << "    debug_level: " << level << "\n"
+          << "    release_level: " << level << "\n"
+          << "    flush_on: trace\n"
+          << "    pattern: \"%v\"\n"
+          << "    watch: true\n"
+          << "    watch_debounce_ms: 50\n"
+          << "    watch_poll_ms: 50\n"
+          << "  sinks:\n"
+          << "    - type: basic_file_sink_mt\n"
+          << "      level: trace\n"
+          << "      file_path: " << logFile << "\n"
+          << "      truncate: false\n";
+    };
+    auto waitFor = [](const std::function<bool()>& done) {
+        for (int i = 0; i < 500 && !done(); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return done();
+    };
+
+    Logger::shutdown();
+    writeConfig(configPath, "warn");
+    Logger::setConfigPath(configPath, false);
+    CHECK(Logger::configReloadStats().watching, "watcher not started");
+
+    std::atomic<int> received{0};
+    const std::string id = Logger::addCallBack(
+        [&](const LogMsg& msg) {
+            if (msg.msg.find("WATCH_") != std::string::npos) ++received;
+        },
+        LogLevel::Trace);
+    LOG_INFO("WATCH_FILTERED");
+
+    // 编辑器式保存：写临时文件后 rename 覆盖
+    const ConfigReloadStats before = Logger::configReloadStats();
+    writeConfig(configPath + ".tmp", "trace");
+    fs::rename(configPath + ".tmp", configPath);
+    CHECK(waitFor([&] { return Logger::configReloadStats().reloads > before.reloads; }), "config change not reloaded");
+    CHECK(Logger::shouldLog(LogLevel::Info), "reloaded level not applied");
+    LOG_INFO("WATCH_AFTER_RELOAD");
+    CHECK(received.load() == 1, "callback lost across reload: " + std::to_string(received.load()));
+
+    // 写错的配置：计入失败，当前配置继续工作，配置文件不被默认配置覆盖
+    const std::string broken = "log_config: [unclosed\n";
+    {
+        std::ofstream f(configPath);
+        f << broken;
+    }
+    CHECK(waitFor([&] { return Logger::configReloadStats().failures > before.failures; }), "broken config not detected");
+    LOG_INFO("WATCH_STILL_WORKING");
+    CHECK(readFile(configPath) == broken, "broken config file was overwritten");
+
+    const ConfigReloadStats stats = Logger::configReloadStats();
+    CHECK(!stats.lastError.empty(), "failure reason not recorded");
+    CHECK(stats.maxLatency >= stats.lastLatency, "latency stats inconsistent");
+    Logger::removeCallBack(id);
+    Logger::shutdown();
+    CHECK(!Logger::configReloadStats().watching, "watcher still running after shutdown");
+
+    CHECK(!fileContains(logFile, "WATCH_FILTERED"), "message below the original level was logged");
+    CHECK(fileContains(logFile, "WATCH_AFTER_RELOAD"), "message after reload missing");
+    CHECK(fileContains(logFile, "WATCH_STILL_WORKING"), "working config replaced after a broken edit");
+    PASS();
+}
+
+// 6.3) 日志统计：按级别计数、自定义 sink 的写入 / 滚动 / 刷新计数、定期输出
+void test_stats(const std::string& dir) {
+    TEST("stats: level / sink counters and periodic Prometheus dump");
+
+    const std::string configPath = dir + "stats.yaml";
+    const std::string logFile = dir + "stats_count.log";
+    const std::string promFile = dir + "stats.prom";
+    const std::string statsLog = dir + "stats_dump.log";
+    {
+        std::ofstream f(configPath);
+        f << "log_config:\n"
+          << "  logger:\n"
+          << "    name: test-stats\n"
+          << "    debug_level: info\n"
+          << "    release_level: info\n"
+          << "    flush_on: trace\n"
+          << "    pattern: \"%v\"\n"
+          << "  stats:\n"
+          << "    interval_ms: 20\n"
+          << "    prometheus_file: " << promFile << "\n"
+          << "    file_path: " << statsLog << "\n"
+          << "  sinks:\n"
+          << "    - type: count_rotating_file_mt\n"
+          << "      level: trace\n"
+          << "      file_path: " << logFile << "\n"
+          << "      max_count: 10\n"
+          << "      max_files: 3\n"
+          << "      strict_count_on_open: false\n"
+          << "    - type: \"null\"\n"
+          << "      level: warn\n";
+    }
+
+    Logger::shutdown();
+    Logger::setConfigPath(configPath, false);
+    const std::string id = Logger::addCallBack([](const LogMsgView&) {}, LogLevel::Info);
+
+    const LoggerStats before = Logger::getStats();
+    const auto info = static_cast<std::size_t>(LogLevel::Info);
+    const auto debug = static_cast<std::size_t>(LogLevel::Debug);
+    const int N = 25;
+    for (int i = 0; i < N; ++i) {
+        LOG_INFO("STATS_", i);
+        LOG_DEBUG("STATS_DEBUG_", i);// 被宏内联过滤，不进入库内
+    }
+    Logger::debug(GET_LINE, {std::string("STATS_DIRECT_DEBUG")});
+
+    const LoggerStats stats = Logger::getStats();
+    CHECK(stats.levels[info].accepted - before.levels[info].accepted == N, "info accepted delta wrong");
+    CHECK(stats.levels[info].written - before.levels[info].written == N, "info written delta wrong");
+    CHECK(stats.levels[debug].filtered - before.levels[debug].filtered == 1, "direct debug call not counted as filtered");
+    CHECK(stats.total.accepted >= stats.levels[info].accepted, "total smaller than a single level");
+    CHECK(!stats.async && stats.queueDepth == 0, "sync config reports an async queue");
+    CHECK(stats.flushes >= static_cast<std::uint64_t>(N), "flush_on trace flushes: " + std::to_string(stats.flushes));
+    CHECK(stats.sinks.size() == 3, "expected 3 sinks, got " + std::to_string(stats.sinks.size()));
+
+    const SinkStats& rotating = stats.sinks[0];
+    CHECK(rotating.sink == "count_rotating_file_mt#0" && rotating.detailed, "rotating sink label: " + rotating.sink);
+    CHECK(rotating.written == static_cast<std::uint64_t>(N), "rotating written " + std::to_string(rotating.written));
+    CHECK(rotating.rotations == 2, "rotations " + std::to_string(rotating.rotations));
+    CHECK(rotating.bytes > 0 && rotating.flushes >= rotating.written, "rotating bytes / flushes not counted");
+    const SinkStats& null = stats.sinks[1];
+    CHECK(null.sink == "null#1" && !null.detailed, "null sink label: " + null.sink);
+    CHECK(null.written == 0 && null.filtered == static_cast<std::uint64_t>(N), "null sink level not applied");
+    const SinkStats& callback = stats.sinks[2];
+    CHECK(callback.sink == "callback:" + id && callback.detailed, "callback label: " + callback.sink);
+    CHECK(callback.written == static_cast<std::uint64_t>(N), "callback written " + std::to_string(callback.written));
+
+    for (int i = 0; i < 200 && !fs::exists(promFile); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    Logger::removeCallBack(id);
+    Logger::shutdown();// 停止定期输出前再输出一次
+    CHECK(Logger::getStats().sinks.empty(), "sink stats survive shutdown");
+    CHECK(fileContains(promFile, "logger_sink_written_total{sink=\"count_rotating_file_mt#0\"} 25\n"),
+          "Prometheus file missing sink counter");
+    CHECK(fileContains(promFile, "logger_messages_total{level=\"info\",outcome=\"accepted\"}"),
+          "Prometheus file missing level counter");
+    CHECK(fileContains(statsLog, "count_rotating_file_mt#0 written=25"), "stats log missing sink summary");
+
+    // 不区分级别的丢弃（此处为异步回调队列）计入 total.dropped
+    Logger::setConfigPath(configPath, false);
+    std::atomic<bool> release{false};
+    CallbackOptions options;
+    options.mode = CallbackMode::Async;
+    options.queueSize = 4;
+    options.overflow = CallbackOverflow::DropNewest;
+    const std::string slowId = Logger::addCallBack(
+            [&](const LogMsgView&) {
+                while (!release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            },
+            LogLevel::Info, options);
+    const LoggerStats beforeDrop = Logger::getStats();
+    for (int i = 0; i < 50; ++i) {
+        LOG_INFO("STATS_DROP_", i);
+    }
+    const std::uint64_t callbackDrops = Logger::callBackDropCount(slowId);
+    const LoggerStats afterDrop = Logger::getStats();
+    release = true;
+    Logger::removeCallBack(slowId);
+    Logger::shutdown();
+    CHECK(callbackDrops > 0, "slow async callback dropped nothing");
+    CHECK(afterDrop.total.dropped - beforeDrop.total.dropped >= callbackDrops,
+          "callback drops missing from total: " + std::to_string(afterDrop.total.dropped));
+    PASS();
+}
+
 // 7) 边界条件：空消息、单空参数
 void test_edge_cases(const std::string& configPath, const std::string& logFile) {
     TEST("edge cases: empty/single-empty-any");
@@ -389,6 +1674,49 @@ void test_edge_cases(const std::string& configPath, const std::string& logFile)
     PASS();
 }
 
+// 7.1) float_precision：即时格式化、std::any 旧接口与延迟解码（binary_file_mt 触发）三条路径一致
+void test_float_precision(const std::string& configPath, const std::string& logFile, const std::string& binFile) {
+    TEST("float_precision applies to template, std::any and record paths");
+
+    {
+        std::ofstream f(configPath);
+        f << "log_config:\n"
+          << "  logger:\n"
+          << "    name: test-precision\n"
+          << "    debug_level: trace\n"
+          << "    release_level: trace\n"
+          << "    flush_on: trace\n"
+          << "    pattern: \"[%l]%v\"\n"
+          << "    async: false\n"
+          << "    float_precision: 2\n"
+          << "  sinks:\n"
+          << "    - type: basic_file_sink_mt\n"
+          << "      level: trace\n"
+          << "      file_path: " << logFile << "\n"
+          << "      truncate: false\n";// 第二次加载时保留前面的输出
+    }
+    Logger::setConfigPath(configPath, false);
+    LOG_INFO("prec_tpl:", 3.14159f, ',', 2.0, ',', 7);
+    Logger::info(GET_LINE, {"prec_any:", 3.14159f, ",", 2.0});
+
+    // 追加一个 binary_file_mt，文本 sink 改由延迟格式化解码记录
+    {
+        std::ofstream f(configPath, std::ios::app);
+        f << "    - type: binary_file_mt\n"
+          << "      level: trace\n"
+          << "      file_path: " << binFile << "\n"
+          << "      truncate: true\n";
+    }
+    Logger::setConfigPath(configPath, false);
+    LOG_INFO("prec_rec:", 3.14159f, ',', 2.0, ',', 7);
+
+    std::string content = readFile(logFile);
+    CHECK(content.find("prec_tpl:3.14,2.00,7") != std::string::npos, "template path precision mismatch");
+    CHECK(content.find("prec_any:3.14,2.00") != std::string::npos, "std::any path precision mismatch");
+    CHECK(content.find("prec_rec:3.14,2.00,7") != std::string::npos, "record path precision mismatch");
+    PASS();
+}
+
 // 8) showCodeLine 验证
 void test_show_codeline(const std::string& configPath, const std::string& logFile) {
     TEST("showCodeLine: file/line info in output");
@@ -463,21 +1791,44 @@ int main() {
 
     test_all_levels(syncLog);
     test_data_types(syncLog);
+    test_variadic_api(syncLog);
+    test_extended_types(syncLog);
+    test_number_format(syncLog);
+    test_wide_strings(syncLog);
+    test_log_site(syncLog);
+    test_steady_state_allocs(syncLog);
     test_callback();
+    test_callback_view();
 
     // ---- 异步测试 ----
     std::cout << "[2] Async tests\n";
     writeAsyncConfig(asyncConfig, asyncLog);
     test_async(asyncConfig, asyncLog, syncLog);
+    test_async_thread_tuning(TEST_DIR + "async/");
+    test_async_sink(TEST_DIR + "async/");
+    test_async_overflow(TEST_DIR + "async/");
+    test_async_per_thread(TEST_DIR + "async/");
+    test_async_batch(TEST_DIR + "async/");
+    test_async_deferred(TEST_DIR + "async/deferred.yaml", TEST_DIR + "async/deferred.log");
+    test_binary_file(TEST_DIR + "async/binary.yaml", TEST_DIR + "async/binary.blog", TEST_DIR + "async/binary.log");
 
     // ---- 多线程测试 ----
     std::cout << "[3] Multi-thread tests\n";
     writeSyncConfig(mtConfig, mtLog, "trace");
     test_multithread(mtConfig, mtLog);
+    test_hot_swap(TEST_DIR + "mt/");
+    test_swap_in_callback(TEST_DIR + "mt/");
+    test_shutdown_in_callback(TEST_DIR + "mt/");
+    test_callback_churn(mtConfig);
+    test_async_callback(mtConfig);
+    test_batch_callback(mtConfig);
 
     // ---- 级别过滤测试 ----
     std::cout << "[4] Level filter tests\n";
     test_level_filter(filterConfig, filterLog);
+    test_level_gate();
+    test_config_watch(TEST_DIR + "filter/");
+    test_stats(TEST_DIR + "filter/");
 
     // ---- 边界与格式测试 ----
     std::cout << "[5] Edge cases & formatting tests\n";
@@ -490,6 +1841,7 @@ int main() {
     std::string sclLog    = TEST_DIR + "scl/test.log";
     fs::create_directories(TEST_DIR + "scl");
     test_show_codeline(sclConfig, sclLog);
+    test_float_precision(sclConfig, TEST_DIR + "scl/precision.log", TEST_DIR + "scl/precision.blog");
 
     // ---- 关闭测试 ----
     std::cout << "[6] Shutdown tests\n";
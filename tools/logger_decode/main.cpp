@@ -0,0 +1,362 @@
+/*************************************************
+  * 描述：binary_file_mt 二进制日志离线解码工具
+  *
+  * 用法：logger_decode <输入文件> [-o 输出文件] [--pattern 输出格式]
+  *  - 默认输出到标准输出
+  *  - 默认使用文件段头中记录的输出格式（即写入时配置文件中的 pattern）还原文本
+  *
+  * File：main.cpp
+  * Author：chenyujin@mozihealthcare.cn
+  * Date：2026/10/16
+  * Update：
+  * ************************************************/
+#include "binary_file_sink.hpp"
+#include "record_text.hpp"
+
+#include <spdlog/details/log_msg.h>
+#include <spdlog/pattern_formatter.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	struct Site
+	{
+		int line = 0;
+		std::string file;
+		std::string func;
+		std::vector<std::string> strings;// 与 binary_file_mt 对应的重复字符串引用表
+	};
+
+	void printUsage()
+	{
+		std::cerr << "用法: logger_decode <输入文件> [-o 输出文件] [--pattern 输出格式]" << std::endl;
+	}
+
+	class Decoder
+	{
+	public:
+		Decoder(std::FILE* out, std::string patternOverride)
+			: m_out(out), m_patternOverride(std::move(patternOverride)) {}
+
+		/// 解码整个文件，遇到损坏数据时返回 false（已解码的部分照常输出）
+		bool decode(std::string_view data)
+		{
+			CustomSink::binary_log::reader in(data);
+			bool hasSegment = false;
+			while (!in.eof())
+			{
+				char tag;
+				in.get_bytes(&tag, 1);
+				bool ok = false;
+				if (tag == CustomSink::binary_log::kTagSegment)
+				{
+					ok = readSegment(in);
+					hasSegment = ok;
+				}
+				else if (tag == CustomSink::binary_log::kTagSite && hasSegment)
+				{
+					ok = readSite(in);
+				}
+				else if (tag == CustomSink::binary_log::kTagMessage && hasSegment)
+				{
+					ok = readMessage(in);
+				}
+				if (!ok)
+				{
+					std::cerr << "[logger_decode] 数据损坏，偏移: " << in.pos() << std::endl;
+					return false;
+				}
+			}
+			return true;
+		}
+
+		std::size_t count() const { return m_count; }
+
+	private:
+		bool readSegment(CustomSink::binary_log::reader& in)
+		{
+			char magic[sizeof(CustomSink::binary_log::kMagic) - 1];// 首字节已作为 tag 读出
+			std::uint16_t version;
+			std::string_view pattern;
+			std::string_view name;
+			std::uint64_t floatPrecision;
+			if (!in.get_bytes(magic, sizeof(magic)) ||
+				std::memcmp(magic, CustomSink::binary_log::kMagic + 1, sizeof(magic)) != 0 ||
+				!in.get_bytes(&version, sizeof(version)) || version != CustomSink::binary_log::kVersion ||
+				!in.get_string(pattern) || !in.get_string(name) || !in.get_varint(floatPrecision) ||
+				!in.get_bytes(&m_lastTimeNs, sizeof(m_lastTimeNs)))
+			{
+				return false;
+			}
+
+			m_sites.clear();
+			m_loggerName.assign(name.data(), name.size());
+			m_floatPrecision = static_cast<int>(CustomSink::binary_log::zigzag_decode(floatPrecision));
+			m_formatter = std::make_unique<spdlog::pattern_formatter>(
+					m_patternOverride.empty() ? std::string(pattern) : m_patternOverride);
+			return true;
+		}
+
+		bool readSite(CustomSink::binary_log::reader& in)
+		{
+			std::uint64_t id;
+			std::uint64_t line;
+			std::string_view file;
+			std::string_view func;
+			if (!in.get_varint(id) || !in.get_varint(line) || !in.get_string(file) || !in.get_string(func))
+			{
+				return false;
+			}
+			Site& site = m_sites[id];
+			site.line = static_cast<int>(line);
+			site.file.assign(file.data(), file.size());
+			site.func.assign(func.data(), func.size());
+			return true;
+		}
+
+		bool readMessage(CustomSink::binary_log::reader& in)
+		{
+			std::uint64_t siteId;
+			std::uint64_t delta;
+			std::uint8_t level;
+			std::uint64_t threadId;
+			std::uint8_t kind;
+			if (!in.get_varint(siteId) || !in.get_varint(delta) || !in.get_bytes(&level, 1) ||
+				!in.get_varint(threadId) || !in.get_bytes(&kind, 1) || level >= spdlog::level::n_levels)
+			{
+				return false;
+			}
+			m_lastTimeNs += CustomSink::binary_log::zigzag_decode(delta);
+
+			spdlog::source_loc source;
+			if (siteId != 0)
+			{
+				auto it = m_sites.find(siteId);
+				if (it == m_sites.end())
+				{
+					return false;
+				}
+				source = spdlog::source_loc(it->second.file.c_str(), it->second.line, it->second.func.c_str());
+			}
+
+			m_text.clear();
+			if (kind == CustomSink::binary_log::kPayloadRecord)
+			{
+				std::uint64_t flags;
+				std::uint64_t argCount;
+				if (!in.get_varint(flags) || !in.get_varint(argCount) || argCount > 0xFFFF)
+				{
+					return false;
+				}
+				Site& strings = m_sites[siteId];// site 0 同样有自己的引用表
+				bool argsOk = true;
+				CustomSink::format_message_text(static_cast<std::uint16_t>(flags), static_cast<std::uint16_t>(argCount),
+												source, m_text, [&](spdlog::memory_buf_t& out) {
+													argsOk = readArgs(in, argCount, strings.strings, out, m_floatPrecision);
+													return argsOk;
+												});
+				if (!argsOk)
+				{
+					return false;
+				}
+			}
+			else if (kind == CustomSink::binary_log::kPayloadText)
+			{
+				std::string_view payload;
+				if (!in.get_string(payload))
+				{
+					return false;
+				}
+				m_text.append(payload.data(), payload.data() + payload.size());
+			}
+			else
+			{
+				return false;
+			}
+
+			const auto time = spdlog::log_clock::time_point(
+					std::chrono::duration_cast<spdlog::log_clock::duration>(std::chrono::nanoseconds(m_lastTimeNs)));
+			spdlog::details::log_msg msg(time, source, m_loggerName, static_cast<spdlog::level::level_enum>(level),
+										 spdlog::string_view_t(m_text.data(), m_text.size()));
+			msg.thread_id = static_cast<std::size_t>(threadId);
+
+			m_line.clear();
+			m_formatter->format(msg, m_line);
+			std::fwrite(m_line.data(), 1, m_line.size(), m_out);
+			++m_count;
+			return true;
+		}
+
+		// 按 binary_file_mt 的参数编码逐个解码，并用与 worker 相同的实现格式化
+		static bool readArgs(CustomSink::binary_log::reader& in, std::uint64_t argCount,
+							 std::vector<std::string>& strings, spdlog::memory_buf_t& out, int floatPrecision)
+		{
+			using LoggerUtil::LogArgTag;
+			using LoggerUtil::LogRecordReader;
+			if (strings.size() < argCount)
+			{
+				strings.resize(argCount);
+			}
+			for (std::uint64_t i = 0; i < argCount; ++i)
+			{
+				std::uint8_t tag;
+				if (!in.get_bytes(&tag, 1))
+				{
+					return false;
+				}
+				switch (tag)
+				{
+					case static_cast<std::uint8_t>(LogArgTag::Bool):
+					case static_cast<std::uint8_t>(LogArgTag::Char):
+					{
+						char v;
+						if (!in.get_bytes(&v, 1)) return false;
+						if (tag == static_cast<std::uint8_t>(LogArgTag::Bool))
+							LogRecordReader::appendValue(out, v != 0);
+						else
+							LogRecordReader::appendValue(out, v);
+						break;
+					}
+					case static_cast<std::uint8_t>(LogArgTag::WChar):
+					{
+						std::uint64_t v;
+						if (!in.get_varint(v)) return false;
+						LogRecordReader::appendValue(out, static_cast<wchar_t>(v));
+						break;
+					}
+					case static_cast<std::uint8_t>(LogArgTag::Int):
+					{
+						std::uint64_t v;
+						if (!in.get_varint(v)) return false;
+						LogRecordReader::appendValue(out, CustomSink::binary_log::zigzag_decode(v));
+						break;
+					}
+					case static_cast<std::uint8_t>(LogArgTag::UInt):
+					{
+						std::uint64_t v;
+						if (!in.get_varint(v)) return false;
+						LogRecordReader::appendValue(out, v);
+						break;
+					}
+					case static_cast<std::uint8_t>(LogArgTag::Float):
+					{
+						float v;
+						if (!in.get_bytes(&v, sizeof(v))) return false;
+						LogRecordReader::appendValue(out, v, floatPrecision);
+						break;
+					}
+					case static_cast<std::uint8_t>(LogArgTag::Double):
+					{
+						double v;
+						if (!in.get_bytes(&v, sizeof(v))) return false;
+						LogRecordReader::appendValue(out, v, floatPrecision);
+						break;
+					}
+					case static_cast<std::uint8_t>(LogArgTag::Str):
+					{
+						std::string_view v;
+						if (!in.get_string(v)) return false;
+						LogRecordReader::appendValue(out, v);
+						CustomSink::binary_log::remember_string(strings[i], v);
+						break;
+					}
+					case CustomSink::binary_log::kArgStrRepeat:
+						LogRecordReader::appendValue(out, std::string_view(strings[i]));
+						break;
+					default:
+						return false;
+				}
+			}
+			return true;
+		}
+
+		std::FILE* m_out;
+		std::string m_patternOverride;
+
+		std::unique_ptr<spdlog::formatter> m_formatter;
+		std::string m_loggerName;
+		std::unordered_map<std::uint64_t, Site> m_sites;
+		std::int64_t m_lastTimeNs = 0;
+		int m_floatPrecision = LoggerUtil::kShortestFloat;
+
+		spdlog::memory_buf_t m_text;
+		spdlog::memory_buf_t m_line;
+		std::size_t m_count = 0;
+	};
+}// namespace
+
+int main(int argc, char* argv[])
+{
+	std::string inputPath;
+	std::string outputPath;
+	std::string pattern;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if ((arg == "-o" || arg == "--output") && i + 1 < argc)
+		{
+			outputPath = argv[++i];
+		}
+		else if (arg == "--pattern" && i + 1 < argc)
+		{
+			pattern = argv[++i];
+		}
+		else if (arg == "-h" || arg == "--help")
+		{
+			printUsage();
+			return 0;
+		}
+		else if (inputPath.empty())
+		{
+			inputPath = arg;
+		}
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+	if (inputPath.empty())
+	{
+		printUsage();
+		return 1;
+	}
+
+	std::ifstream in(inputPath, std::ios::in | std::ios::binary);
+	if (!in.is_open())
+	{
+		std::cerr << "[logger_decode] 无法打开输入文件: " << inputPath << std::endl;
+		return 1;
+	}
+	const std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+	std::FILE* out = stdout;
+	if (!outputPath.empty())
+	{
+		out = std::fopen(outputPath.c_str(), "wb");
+		if (!out)
+		{
+			std::cerr << "[logger_decode] 无法打开输出文件: " << outputPath << std::endl;
+			return 1;
+		}
+	}
+
+	Decoder decoder(out, pattern);
+	const bool ok = decoder.decode(data);
+	if (out != stdout)
+	{
+		std::fclose(out);
+	}
+	std::cerr << "[logger_decode] 已解码 " << decoder.count() << " 条日志" << std::endl;
+	return ok ? 0 : 2;
+}